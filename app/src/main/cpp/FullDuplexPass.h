@@ -8,6 +8,9 @@
 #include <thread>
 #include <cmath>
 #include <atomic>
+#include <algorithm>
+#include <mutex>
+#include "SoftClamp.h"
 
 #define FDP_LOG_TAG "FullDuplexPass"
 #define FDP_LOGI(...) __android_log_print(ANDROID_LOG_INFO, FDP_LOG_TAG, __VA_ARGS__)
@@ -28,17 +31,54 @@ public:
 
     // Latency tuning parameters
     // Target buffer: how many frames we want to maintain in input buffer (lower = less latency, more risk)
-    void setTargetBufferFrames(int32_t frames) { mTargetBufferFrames.store(frames, std::memory_order_relaxed); }
+    void setTargetBufferFrames(int32_t frames) {
+        mTargetBufferFrames.store(frames, std::memory_order_relaxed);
+        selectProcess();
+    }
     int32_t getTargetBufferFrames() const { return mTargetBufferFrames.load(std::memory_order_relaxed); }
 
     // Drain rate: how many extra frames to read per callback when over target (higher = faster drain, more artifacts)
     // 0 = no draining (current behavior), 1.0 = read double frames, 0.5 = read 50% extra
-    void setDrainRate(float rate) { mDrainRate.store(rate, std::memory_order_relaxed); }
+    void setDrainRate(float rate) {
+        mDrainRate.store(rate, std::memory_order_relaxed);
+        selectProcess();
+    }
     float getDrainRate() const { return mDrainRate.load(std::memory_order_relaxed); }
 
     // Get current buffer level for UI display
+    // Without draining this is only sampled every kStatsPollInterval callbacks
     int32_t getCurrentBufferFrames() const { return mLastAvailableFrames.load(std::memory_order_relaxed); }
 
+    // Cache stream properties and pick the specialized callback for this layout.
+    // Call once both streams are open and before start(); stream properties don't
+    // change while a stream is open, so the audio callback never queries them.
+    void configure() {
+        std::lock_guard<std::mutex> lock(mSelectMutex);
+        mOutputChannelCount = mOutputStream ? mOutputStream->getChannelCount() : 0;
+        mOutputBytesPerFrame = mOutputStream ? mOutputStream->getBytesPerFrame() : 0;
+        mInputChannelCount = mInputStream ? mInputStream->getChannelCount() : 0;
+        mInputSampleRate = mInputStream ? mInputStream->getSampleRate() : 0;
+
+        bool isFloat = mInputStream && mOutputStream
+                       && mInputStream->getFormat() == oboe::AudioFormat::Float
+                       && mOutputStream->getFormat() == oboe::AudioFormat::Float;
+        if (!isFloat) {
+            mLayout = Layout::Silence;
+        } else if (mInputChannelCount == 1 && mOutputChannelCount == 2) {
+            mLayout = Layout::MonoToStereo;
+        } else if (mInputChannelCount == mOutputChannelCount) {
+            mLayout = Layout::Matched;
+        } else {
+            mLayout = Layout::Silence;
+        }
+        selectProcessLocked();
+
+        FDP_LOGI("Configured: input=%dch, output=%dch, layout=%s",
+                 mInputChannelCount, mOutputChannelCount,
+                 mLayout == Layout::MonoToStereo ? "mono->stereo"
+                 : mLayout == Layout::Matched ? "matched" : "silence");
+    }
+
     oboe::Result start() {
         mCallbackCount = 0;
         mTotalFramesRead = 0;
@@ -84,62 +124,121 @@ public:
             int32_t numFrames) override {
 
         mCallbackCount++;
-        float *outputFloats = static_cast<float *>(audioData);
-        int32_t outputChannelCount = outputStream->getChannelCount();
+        if (mCallbackCount % kStatsPollInterval == 0) {
+            pollStats(outputStream);
+        }
+        return mProcess.load(std::memory_order_relaxed)(this, static_cast<float *>(audioData), numFrames);
+    }
+
+private:
+    // Channel layouts the callback is specialized for
+    enum class Layout { Silence, MonoToStereo, Matched };
+
+    using ProcessFn = oboe::DataCallbackResult (*)(FullDuplexPass *, float *, int32_t);
+
+    // XRun counts and (without draining) the buffer level are polled every N callbacks:
+    // ~64ms at 48-frame MMAP bursts, well under the UI's 500ms refresh
+    static constexpr int32_t kStatsPollInterval = 64;
+
+    // Re-picked from the UI thread when the drain settings change.
+    // The mutex serializes concurrent setters and configure() so the layout is read
+    // consistently and the last store reflects the latest settings; the audio
+    // thread never takes it and only loads mProcess.
+    void selectProcess() {
+        std::lock_guard<std::mutex> lock(mSelectMutex);
+        selectProcessLocked();
+    }
+
+    void selectProcessLocked() {
+        bool drain = mDrainRate.load(std::memory_order_relaxed) > 0.0f
+                     && mTargetBufferFrames.load(std::memory_order_relaxed) > 0;
+        ProcessFn selected = &processSilence;
+        if (mLayout == Layout::MonoToStereo) {
+            selected = drain ? &process<Layout::MonoToStereo, true> : &process<Layout::MonoToStereo, false>;
+        } else if (mLayout == Layout::Matched) {
+            selected = drain ? &process<Layout::Matched, true> : &process<Layout::Matched, false>;
+        }
+        mProcess.store(selected, std::memory_order_relaxed);
+    }
+
+    static bool isDrainVariant(ProcessFn fn) {
+        return fn == &process<Layout::MonoToStereo, true> || fn == &process<Layout::Matched, true>;
+    }
 
-        // Check for XRuns (buffer underruns/overruns)
+    void pollStats(oboe::AudioStream *outputStream) {
         if (mInputStream) {
             auto inputXRunResult = mInputStream->getXRunCount();
             if (inputXRunResult && inputXRunResult.value() > mInputXRunCount) {
                 FDP_LOGW("Input XRun detected! Total: %d", inputXRunResult.value());
                 mInputXRunCount = inputXRunResult.value();
             }
+            // The drain variants already sample this on every callback
+            if (!isDrainVariant(mProcess.load(std::memory_order_relaxed))) {
+                auto availResult = mInputStream->getAvailableFrames();
+                mLastAvailableFrames.store(availResult ? availResult.value() : 0, std::memory_order_relaxed);
+            }
         }
         auto outputXRunResult = outputStream->getXRunCount();
         if (outputXRunResult && outputXRunResult.value() > mOutputXRunCount) {
             FDP_LOGW("Output XRun detected! Total: %d", outputXRunResult.value());
             mOutputXRunCount = outputXRunResult.value();
         }
+    }
 
-        if (!mInputStream) {
-            // No input, fill with silence
-            memset(outputFloats, 0, numFrames * outputChannelCount * sizeof(float));
-            return oboe::DataCallbackResult::Continue;
-        }
+    // No input or an unsupported layout/format: fill with silence in the output's
+    // own sample format, which need not be float here
+    static oboe::DataCallbackResult processSilence(FullDuplexPass *self, float *outputFloats, int32_t numFrames) {
+        memset(outputFloats, 0, numFrames * self->mOutputBytesPerFrame);
+        return oboe::DataCallbackResult::Continue;
+    }
 
-        int32_t inputChannelCount = mInputStream->getChannelCount();
+    template <Layout layout, bool drain>
+    static oboe::DataCallbackResult process(FullDuplexPass *self, float *outputFloats, int32_t numFrames) {
+        return self->processImpl<layout, drain>(outputFloats, numFrames);
+    }
 
+    template <Layout layout, bool drain>
+    oboe::DataCallbackResult processImpl(float *outputFloats, int32_t numFrames) {
         // Load atomic tuning parameters once per callback
-        float drainRate = mDrainRate.load(std::memory_order_relaxed);
-        int32_t targetBufferFrames = mTargetBufferFrames.load(std::memory_order_relaxed);
         float gain = mGain.load(std::memory_order_relaxed);
 
-        // Check how many frames are available
-        auto availResult = mInputStream->getAvailableFrames();
-        int32_t availableFrames = availResult ? availResult.value() : 0;
-        mLastAvailableFrames.store(availableFrames, std::memory_order_relaxed);
-
         // Calculate how many frames to read
         // Base: numFrames (what output needs)
         // Extra: if buffer is over target and draining is enabled, read more to gradually reduce
         int32_t framesToRead = numFrames;
         int32_t framesDrained = 0;
-
-        if (drainRate > 0.0f && targetBufferFrames > 0) {
-            int32_t excessFrames = availableFrames - targetBufferFrames;
-            if (excessFrames > 0) {
-                // Gradually drain: read extra frames based on drain rate
-                // drainRate 0.5 = read 50% extra, 1.0 = read double
-                int32_t extraFrames = static_cast<int32_t>(numFrames * drainRate);
-                // Don't drain more than the excess
-                extraFrames = std::min(extraFrames, excessFrames);
-                framesToRead = numFrames + extraFrames;
-                framesDrained = extraFrames;
+        int32_t availableFrames = 0;
+        float drainRate = 0.0f;
+        int32_t targetBufferFrames = 0;
+
+        if constexpr (drain) {
+            drainRate = mDrainRate.load(std::memory_order_relaxed);
+            targetBufferFrames = mTargetBufferFrames.load(std::memory_order_relaxed);
+
+            // Check how many frames are available
+            auto availResult = mInputStream->getAvailableFrames();
+            availableFrames = availResult ? availResult.value() : 0;
+            mLastAvailableFrames.store(availableFrames, std::memory_order_relaxed);
+
+            // Settings may have been switched off since this variant was selected
+            if (drainRate > 0.0f && targetBufferFrames > 0) {
+                int32_t excessFrames = availableFrames - targetBufferFrames;
+                if (excessFrames > 0) {
+                    // Gradually drain: read extra frames based on drain rate
+                    // drainRate 0.5 = read 50% extra, 1.0 = read double
+                    int32_t extraFrames = static_cast<int32_t>(numFrames * drainRate);
+                    // Don't drain more than the excess
+                    extraFrames = std::min(extraFrames, excessFrames);
+                    framesToRead = numFrames + extraFrames;
+                    framesDrained = extraFrames;
+                }
             }
+        } else {
+            availableFrames = mLastAvailableFrames.load(std::memory_order_relaxed);
         }
 
         // Ensure buffer is large enough
-        int32_t inputSamplesNeeded = framesToRead * inputChannelCount;
+        int32_t inputSamplesNeeded = framesToRead * mInputChannelCount;
         if (mInputBuffer.size() < static_cast<size_t>(inputSamplesNeeded)) {
             mInputBuffer.resize(inputSamplesNeeded);
         }
@@ -160,14 +259,14 @@ public:
         // If we read more than needed, use the NEWEST frames (skip oldest)
         int32_t framesToSkip = 0;
         int32_t framesToUse = framesRead;
-        if (framesRead > numFrames) {
+        if (drain && framesRead > numFrames) {
             framesToSkip = framesRead - numFrames;
             framesToUse = numFrames;
         }
 
         // Log periodically (every ~1 second at 48kHz with 240 frame bursts)
         if (mCallbackCount % 200 == 0) {
-            int32_t bufferLatencyMs = (availableFrames * 1000) / mInputStream->getSampleRate();
+            int32_t bufferLatencyMs = (availableFrames * 1000) / mInputSampleRate;
             FDP_LOGI("Callback #%d: avail=%d (%dms), read=%d, skip=%d, target=%d, drain=%.1f",
                      mCallbackCount, availableFrames, bufferLatencyMs, framesRead,
                      framesToSkip, targetBufferFrames, drainRate);
@@ -175,9 +274,9 @@ public:
 
         mTotalFramesWritten += numFrames;
 
-        // Process audio: mono to stereo with gain and soft limiting
+        // Process audio with gain and soft limiting
         // When draining, skip oldest frames and use newest (framesToSkip offset)
-        if (inputChannelCount == 1 && outputChannelCount == 2) {
+        if constexpr (layout == Layout::MonoToStereo) {
             for (int i = 0; i < framesToUse; i++) {
                 // Use frames starting at framesToSkip (newest frames)
                 float sample = mInputBuffer[i + framesToSkip] * gain;
@@ -191,40 +290,20 @@ public:
                 outputFloats[i * 2] = 0.0f;
                 outputFloats[i * 2 + 1] = 0.0f;
             }
-        } else if (inputChannelCount == outputChannelCount) {
-            int32_t skipSamples = framesToSkip * inputChannelCount;
-            for (int i = 0; i < framesToUse * outputChannelCount; i++) {
+        } else {
+            int32_t skipSamples = framesToSkip * mInputChannelCount;
+            for (int i = 0; i < framesToUse * mOutputChannelCount; i++) {
                 float sample = mInputBuffer[i + skipSamples] * gain;
                 outputFloats[i] = softClamp(sample);
             }
-            for (int i = framesToUse * outputChannelCount; i < numFrames * outputChannelCount; i++) {
+            for (int i = framesToUse * mOutputChannelCount; i < numFrames * mOutputChannelCount; i++) {
                 outputFloats[i] = 0.0f;
             }
-        } else {
-            // Fallback: fill with silence
-            memset(outputFloats, 0, numFrames * outputChannelCount * sizeof(float));
         }
 
         return oboe::DataCallbackResult::Continue;
     }
 
-private:
-    // Soft clamp using cubic saturation to prevent hard clipping
-    // Keeps signal in -1.0 to 1.0 range with smooth limiting
-    // Polynomial approximation avoids expensive tanhf in the audio callback
-    inline float softClamp(float x) {
-        if (x > 1.0f) return 1.0f;
-        if (x < -1.0f) return -1.0f;
-        if (x > 0.9f) {
-            float t = (x - 0.9f) * 10.0f;  // normalize 0.9..1.0+ to 0..1
-            return 0.9f + 0.1f * t / (1.0f + t);  // rational saturation
-        } else if (x < -0.9f) {
-            float t = (-x - 0.9f) * 10.0f;
-            return -0.9f - 0.1f * t / (1.0f + t);
-        }
-        return x;
-    }
-
     oboe::AudioStream *mInputStream = nullptr;
     oboe::AudioStream *mOutputStream = nullptr;
     std::atomic<float> mGain{8.0f};
@@ -235,6 +314,15 @@ private:
     std::atomic<float> mDrainRate{0.0f};           // 0 = disabled, 0.5 = gradual, 1.0 = aggressive
     std::atomic<int32_t> mLastAvailableFrames{0};  // For UI display
 
+    // Fixed while the streams are open, cached by configure()
+    int32_t mInputChannelCount = 0;
+    int32_t mOutputChannelCount = 0;
+    int32_t mOutputBytesPerFrame = 0;
+    int32_t mInputSampleRate = 0;
+    Layout mLayout = Layout::Silence;  // Guarded by mSelectMutex
+    std::mutex mSelectMutex;
+    std::atomic<ProcessFn> mProcess{&processSilence};
+
     // Statistics
     int32_t mCallbackCount = 0;
     int64_t mTotalFramesRead = 0;
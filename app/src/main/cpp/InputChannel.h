@@ -0,0 +1,132 @@
+#ifndef GUITARPASSTHROUGH_INPUTCHANNEL_H
+#define GUITARPASSTHROUGH_INPUTCHANNEL_H
+
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "SpscRingBuffer.h"
+
+// One input of the multi-input mixer: an SPSC buffer fed by the input stream's
+// callback and drained by the output callback, plus its gain/pan and counters.
+// Each device runs on its own clock, so the buffer level drifts; pull() absorbs
+// that by dropping the oldest frames when a source runs fast and re-priming
+// after it runs dry when a source runs slow. Both work without any UI tuning.
+class InputChannel {
+public:
+    // Gentle trim used when the UI drain rate is off: at most 1/8 of a burst per callback
+    static constexpr float kDefaultDrainRate = 0.125f;
+
+    InputChannel(int32_t capacityFrames, int32_t channelCount)
+            : mBuffer(capacityFrames, channelCount) {}
+
+    int32_t getChannelCount() const { return mBuffer.getChannelCount(); }
+    int32_t getCapacityFrames() const { return mBuffer.getCapacityFrames(); }
+
+    void setGain(float gain) { mGain.store(gain, std::memory_order_relaxed); }
+    float getGain() const { return mGain.load(std::memory_order_relaxed); }
+
+    // -1.0 = hard left, 0.0 = center, 1.0 = hard right
+    void setPan(float pan) { mPan.store(std::clamp(pan, -1.0f, 1.0f), std::memory_order_relaxed); }
+    float getPan() const { return mPan.load(std::memory_order_relaxed); }
+
+    // Producer (input callback): queue frames; anything that doesn't fit is dropped
+    void push(const float *frames, int32_t numFrames) {
+        int32_t written = mBuffer.write(frames, numFrames);
+        if (written < numFrames) {
+            mOverflowCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Size of the bursts the input stream delivers. The level seen by the output
+    // side jumps by this much on every push, so it sets the minimum cushion and
+    // how far above the target a normal peak may go before it counts as drift.
+    void setInputBurstFrames(int32_t frames) { mInputBurstFrames = std::max(frames, 0); }
+    int32_t getInputBurstFrames() const { return mInputBurstFrames; }
+
+    // Cushion kept when the UI target is off or below it:
+    // max(2 * outputBurst, inputBurst + outputBurst)
+    void setDefaultTargetFrames(int32_t frames) { mDefaultTargetFrames = std::max(frames, 0); }
+    int32_t getDefaultTargetFrames() const { return mDefaultTargetFrames; }
+
+    static int32_t defaultTargetFrames(int32_t outputBurstFrames, int32_t inputBurstFrames) {
+        return std::max(2 * outputBurstFrames, inputBurstFrames + outputBurstFrames);
+    }
+
+    // Consumer (output callback): fill dest with numFrames interleaved frames.
+    // Frames we don't have are zero-filled. Returns the number of real frames.
+    // targetBufferFrames/drainRate are the optional UI tuning; the target never goes
+    // below the default cushion, and a 0 drain rate falls back to kDefaultDrainRate
+    // so a fast source is always trimmed.
+    int32_t pull(float *dest, int32_t numFrames, int32_t targetBufferFrames, float drainRate) {
+        int32_t availableFrames = mBuffer.getAvailableFrames();
+        mLastAvailableFrames.store(availableFrames, std::memory_order_relaxed);
+
+        int32_t target = std::max(targetBufferFrames, mDefaultTargetFrames);
+        float rate = drainRate > 0.0f ? drainRate : kDefaultDrainRate;
+
+        // Wait until a full burst plus the target cushion is queued before playing,
+        // both at start and after an underrun, so a slow source doesn't crackle every burst
+        if (!mPrimed) {
+            if (availableFrames < numFrames + target) {
+                memset(dest, 0, numFrames * getChannelCount() * sizeof(float));
+                return 0;
+            }
+            mPrimed = true;
+        }
+
+        // Fast source: drop oldest frames above the target, same policy as FullDuplexPass.
+        // Right after a push the level legitimately peaks one input burst higher.
+        int32_t excessFrames = availableFrames - target - numFrames - mInputBurstFrames;
+        if (excessFrames > 0) {
+            int32_t extraFrames = std::max(static_cast<int32_t>(numFrames * rate), 1);
+            extraFrames = std::min(extraFrames, excessFrames);
+            mFramesDrained.fetch_add(mBuffer.skip(extraFrames), std::memory_order_relaxed);
+        }
+
+        int32_t framesRead = mBuffer.read(dest, numFrames);
+        if (framesRead < numFrames) {
+            int32_t channelCount = getChannelCount();
+            memset(dest + framesRead * channelCount, 0,
+                   (numFrames - framesRead) * channelCount * sizeof(float));
+            mUnderrunCount.fetch_add(1, std::memory_order_relaxed);
+            mPrimed = false;
+        }
+        return framesRead;
+    }
+
+    // Buffer level seen by the last pull(), for UI display
+    int32_t getBufferedFrames() const { return mLastAvailableFrames.load(std::memory_order_relaxed); }
+
+    // Device-reported XRuns, polled by whoever owns the stream
+    void setStreamXRunCount(int32_t count) { mStreamXRunCount.store(count, std::memory_order_relaxed); }
+
+    int32_t getUnderrunCount() const { return mUnderrunCount.load(std::memory_order_relaxed); }
+    int32_t getOverflowCount() const { return mOverflowCount.load(std::memory_order_relaxed); }
+    int64_t getFramesDrained() const { return mFramesDrained.load(std::memory_order_relaxed); }
+
+    // Stream XRuns plus buffer under/overflows caused by clock drift
+    int32_t getXRunCount() const {
+        return mStreamXRunCount.load(std::memory_order_relaxed) + getUnderrunCount() + getOverflowCount();
+    }
+
+private:
+    SpscRingBuffer mBuffer;
+    std::atomic<float> mGain{1.0f};
+    std::atomic<float> mPan{0.0f};
+    std::atomic<int32_t> mLastAvailableFrames{0};
+
+    std::atomic<int32_t> mStreamXRunCount{0};
+    std::atomic<int32_t> mUnderrunCount{0};
+    std::atomic<int32_t> mOverflowCount{0};
+    std::atomic<int64_t> mFramesDrained{0};
+
+    // Set before the streams start
+    int32_t mDefaultTargetFrames = 0;
+    int32_t mInputBurstFrames = 0;
+
+    // Only touched by the consumer
+    bool mPrimed = false;
+};
+
+#endif // GUITARPASSTHROUGH_INPUTCHANNEL_H
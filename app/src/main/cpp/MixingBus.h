@@ -0,0 +1,93 @@
+#ifndef GUITARPASSTHROUGH_MIXINGBUS_H
+#define GUITARPASSTHROUGH_MIXINGBUS_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "SoftClamp.h"
+
+// Stereo summing bus for the multi-input mode.
+// Accumulates into planar left/right buffers so the inner loops are plain
+// multiply-adds over contiguous floats that the compiler auto-vectorizes (NEON/SSE),
+// then interleaves into the output layout with soft limiting in one final pass.
+class MixingBus {
+public:
+    // Pre-size the accumulators outside the audio callback
+    void prepare(int32_t maxFrames) {
+        if (mLeft.size() < static_cast<size_t>(maxFrames)) {
+            mLeft.resize(maxFrames);
+            mRight.resize(maxFrames);
+        }
+    }
+
+    // numFrames must not exceed the prepared size; never allocates
+    void clear(int32_t numFrames) {
+        memset(mLeft.data(), 0, numFrames * sizeof(float));
+        memset(mRight.data(), 0, numFrames * sizeof(float));
+    }
+
+    // Balance-style pan: center keeps full gain on both sides, matching the
+    // mono-to-stereo duplication of the single-input path
+    static void panGains(float gain, float pan, float &gainLeft, float &gainRight) {
+        gainLeft = gain * std::min(1.0f, 1.0f - pan);
+        gainRight = gain * std::min(1.0f, 1.0f + pan);
+    }
+
+    // Sum one interleaved input into the bus. Mono feeds both sides; stereo and
+    // wider inputs use their first two channels.
+    void add(const float *input, int32_t inputChannelCount, int32_t numFrames,
+             float gainLeft, float gainRight) {
+        float *__restrict left = mLeft.data();
+        float *__restrict right = mRight.data();
+        const float *__restrict in = input;
+
+        if (inputChannelCount == 1) {
+            for (int32_t i = 0; i < numFrames; i++) {
+                left[i] += in[i] * gainLeft;
+                right[i] += in[i] * gainRight;
+            }
+        } else if (inputChannelCount == 2) {
+            for (int32_t i = 0; i < numFrames; i++) {
+                left[i] += in[i * 2] * gainLeft;
+                right[i] += in[i * 2 + 1] * gainRight;
+            }
+        } else {
+            for (int32_t i = 0; i < numFrames; i++) {
+                left[i] += in[i * inputChannelCount] * gainLeft;
+                right[i] += in[i * inputChannelCount + 1] * gainRight;
+            }
+        }
+    }
+
+    // Write the bus to an interleaved output with master gain and soft limiting
+    void render(float *output, int32_t outputChannelCount, int32_t numFrames, float masterGain) const {
+        const float *__restrict left = mLeft.data();
+        const float *__restrict right = mRight.data();
+        float *__restrict out = output;
+
+        if (outputChannelCount == 2) {
+            for (int32_t i = 0; i < numFrames; i++) {
+                out[i * 2] = softClamp(left[i] * masterGain);
+                out[i * 2 + 1] = softClamp(right[i] * masterGain);
+            }
+        } else if (outputChannelCount == 1) {
+            float halfGain = masterGain * 0.5f;
+            for (int32_t i = 0; i < numFrames; i++) {
+                out[i] = softClamp((left[i] + right[i]) * halfGain);
+            }
+        } else {
+            memset(out, 0, numFrames * outputChannelCount * sizeof(float));
+            for (int32_t i = 0; i < numFrames; i++) {
+                out[i * outputChannelCount] = softClamp(left[i] * masterGain);
+                out[i * outputChannelCount + 1] = softClamp(right[i] * masterGain);
+            }
+        }
+    }
+
+private:
+    std::vector<float> mLeft;
+    std::vector<float> mRight;
+};
+
+#endif // GUITARPASSTHROUGH_MIXINGBUS_H
@@ -0,0 +1,226 @@
+#ifndef GUITARPASSTHROUGH_MULTIINPUTPASS_H
+#define GUITARPASSTHROUGH_MULTIINPUTPASS_H
+
+#include <oboe/Oboe.h>
+#include <android/log.h>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include "InputChannel.h"
+#include "MixingBus.h"
+
+#define MIP_LOG_TAG "MultiInputPass"
+#define MIP_LOGI(...) __android_log_print(ANDROID_LOG_INFO, MIP_LOG_TAG, __VA_ARGS__)
+#define MIP_LOGW(...) __android_log_print(ANDROID_LOG_WARN, MIP_LOG_TAG, __VA_ARGS__)
+
+// Multi-input passthrough: every input stream runs its own callback and pushes into
+// a per-input SPSC buffer; the output callback pulls one burst from each and sums
+// them on a MixingBus. Unlike FullDuplexPass, inputs are never read from the output
+// callback, since N devices on N clocks can't all be in sync with it.
+class MultiInputPass : public oboe::AudioStreamDataCallback {
+public:
+    static constexpr int32_t kMaxInputs = 4;
+    // ~85ms at 48kHz: plenty of headroom for drift between drains
+    static constexpr int32_t kInputBufferCapacityFrames = 4096;
+    // Poll stream XRun counts every N callbacks instead of on every burst
+    static constexpr int32_t kXRunPollInterval = 64;
+
+    MultiInputPass() = default;
+
+    // Adds an input before its stream is opened; returns its index or -1 when full.
+    // The returned index selects the callback to set on the input stream builder.
+    int32_t addInput(int32_t channelCount) {
+        if (static_cast<int32_t>(mInputs.size()) >= kMaxInputs) return -1;
+        mInputs.push_back(std::make_unique<InputPort>(kInputBufferCapacityFrames, channelCount));
+        return static_cast<int32_t>(mInputs.size()) - 1;
+    }
+
+    int32_t getInputCount() const { return static_cast<int32_t>(mInputs.size()); }
+    oboe::AudioStreamDataCallback* getInputCallback(int32_t index) { return mInputs[index].get(); }
+    void setInputStream(int32_t index, oboe::AudioStream *stream) {
+        mInputs[index]->stream = stream;
+        if (stream) {
+            mInputs[index]->channel.setInputBurstFrames(stream->getFramesPerBurst());
+        }
+    }
+    InputChannel* getInputChannel(int32_t index) { return &mInputs[index]->channel; }
+    const InputChannel* getInputChannel(int32_t index) const { return &mInputs[index]->channel; }
+
+    void setOutputStream(oboe::AudioStream *stream) {
+        mOutputStream = stream;
+        if (stream) {
+            mOutputChannelCount = stream->getChannelCount();
+            // Callbacks are at most the buffer capacity; anything larger is mixed in chunks
+            prepare(std::max(stream->getBufferCapacityInFrames(), stream->getFramesPerBurst() * 2));
+            // Default drift cushion, sized for each input's own burst
+            for (auto &input : mInputs) {
+                input->channel.setDefaultTargetFrames(InputChannel::defaultTargetFrames(
+                        stream->getFramesPerBurst(), input->channel.getInputBurstFrames()));
+            }
+        }
+    }
+    oboe::AudioStream* getOutputStream() const { return mOutputStream; }
+
+    // Master gain applied on the bus after the per-input gains
+    void setGain(float gain) { mGain.store(gain, std::memory_order_relaxed); }
+    float getGain() const { return mGain.load(std::memory_order_relaxed); }
+
+    void setTargetBufferFrames(int32_t frames) { mTargetBufferFrames.store(frames, std::memory_order_relaxed); }
+    int32_t getTargetBufferFrames() const { return mTargetBufferFrames.load(std::memory_order_relaxed); }
+
+    void setDrainRate(float rate) { mDrainRate.store(rate, std::memory_order_relaxed); }
+    float getDrainRate() const { return mDrainRate.load(std::memory_order_relaxed); }
+
+    // Deepest input buffer, so the UI shows the worst-case added latency
+    int32_t getCurrentBufferFrames() const {
+        int32_t frames = 0;
+        for (const auto &input : mInputs) {
+            frames = std::max(frames, input->channel.getBufferedFrames());
+        }
+        return frames;
+    }
+
+    oboe::Result start() {
+        mCallbackCount = 0;
+        mOutputXRunCount = 0;
+
+        for (auto &input : mInputs) {
+            if (!input->stream) continue;
+            auto result = input->stream->requestStart();
+            if (result != oboe::Result::OK) return result;
+        }
+        // Give the inputs a moment to queue data before the first output callback
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+        if (mOutputStream) {
+            return mOutputStream->requestStart();
+        }
+        return oboe::Result::ErrorNull;
+    }
+
+    oboe::Result stop() {
+        oboe::Result result = oboe::Result::OK;
+        for (auto &input : mInputs) {
+            if (input->stream) {
+                auto inResult = input->stream->requestStop();
+                if (result == oboe::Result::OK) result = inResult;
+            }
+        }
+        if (mOutputStream) {
+            auto outResult = mOutputStream->requestStop();
+            if (result == oboe::Result::OK) result = outResult;
+        }
+
+        // Counters are atomic since the callbacks may still be finishing a burst
+        for (size_t i = 0; i < mInputs.size(); i++) {
+            const InputChannel &channel = mInputs[i]->channel;
+            MIP_LOGI("Input %zu stats: xruns=%d, underruns=%d, overflows=%d, framesDrained=%lld",
+                     i, channel.getXRunCount(), channel.getUnderrunCount(),
+                     channel.getOverflowCount(), (long long)channel.getFramesDrained());
+        }
+        MIP_LOGI("Session stats: callbacks=%d, outputXRuns=%d",
+                 mCallbackCount.load(std::memory_order_relaxed),
+                 mOutputXRunCount.load(std::memory_order_relaxed));
+        return result;
+    }
+
+    oboe::DataCallbackResult onAudioReady(
+            oboe::AudioStream *outputStream,
+            void *audioData,
+            int32_t numFrames) override {
+
+        int32_t callbackCount = mCallbackCount.fetch_add(1, std::memory_order_relaxed) + 1;
+        float *outputFloats = static_cast<float *>(audioData);
+
+        if (callbackCount % kXRunPollInterval == 0) {
+            auto outputXRunResult = outputStream->getXRunCount();
+            if (outputXRunResult && outputXRunResult.value() > mOutputXRunCount.load(std::memory_order_relaxed)) {
+                MIP_LOGW("Output XRun detected! Total: %d", outputXRunResult.value());
+                mOutputXRunCount.store(outputXRunResult.value(), std::memory_order_relaxed);
+            }
+        }
+
+        // Load atomic tuning parameters once per callback
+        float drainRate = mDrainRate.load(std::memory_order_relaxed);
+        int32_t targetBufferFrames = mTargetBufferFrames.load(std::memory_order_relaxed);
+        float gain = mGain.load(std::memory_order_relaxed);
+
+        if (mMaxFrames <= 0) {
+            memset(outputFloats, 0, numFrames * mOutputChannelCount * sizeof(float));
+            return oboe::DataCallbackResult::Continue;
+        }
+
+        // Buffers are sized in setOutputStream(); never allocate here
+        for (int32_t offset = 0; offset < numFrames; offset += mMaxFrames) {
+            int32_t chunkFrames = std::min(numFrames - offset, mMaxFrames);
+            mBus.clear(chunkFrames);
+
+            for (auto &input : mInputs) {
+                InputChannel &channel = input->channel;
+                channel.pull(input->scratch.data(), chunkFrames, targetBufferFrames, drainRate);
+
+                float gainLeft, gainRight;
+                MixingBus::panGains(channel.getGain(), channel.getPan(), gainLeft, gainRight);
+                mBus.add(input->scratch.data(), channel.getChannelCount(), chunkFrames, gainLeft, gainRight);
+            }
+
+            mBus.render(outputFloats + offset * mOutputChannelCount, mOutputChannelCount, chunkFrames, gain);
+        }
+        return oboe::DataCallbackResult::Continue;
+    }
+
+private:
+    // Input stream callback feeding one InputChannel
+    struct InputPort : public oboe::AudioStreamDataCallback {
+        InputPort(int32_t capacityFrames, int32_t channelCount)
+                : channel(capacityFrames, channelCount) {}
+
+        oboe::DataCallbackResult onAudioReady(
+                oboe::AudioStream *inputStream,
+                void *audioData,
+                int32_t numFrames) override {
+            channel.push(static_cast<const float *>(audioData), numFrames);
+
+            if (++callbackCount % kXRunPollInterval == 0) {
+                auto xRunResult = inputStream->getXRunCount();
+                if (xRunResult) {
+                    channel.setStreamXRunCount(xRunResult.value());
+                }
+            }
+            return oboe::DataCallbackResult::Continue;
+        }
+
+        InputChannel channel;
+        oboe::AudioStream *stream = nullptr;
+        std::vector<float> scratch;
+        int32_t callbackCount = 0;
+    };
+
+    void prepare(int32_t maxFrames) {
+        mMaxFrames = maxFrames;
+        mBus.prepare(maxFrames);
+        for (auto &input : mInputs) {
+            input->scratch.resize(static_cast<size_t>(maxFrames) * input->channel.getChannelCount());
+        }
+    }
+
+    std::vector<std::unique_ptr<InputPort>> mInputs;
+    oboe::AudioStream *mOutputStream = nullptr;
+    int32_t mOutputChannelCount = oboe::ChannelCount::Stereo;
+    MixingBus mBus;
+    int32_t mMaxFrames = 0;
+
+    std::atomic<float> mGain{8.0f};
+    std::atomic<int32_t> mTargetBufferFrames{0};
+    std::atomic<float> mDrainRate{0.0f};
+
+    // Statistics (read by stop() while the output callback may still run)
+    std::atomic<int32_t> mCallbackCount{0};
+    std::atomic<int32_t> mOutputXRunCount{0};
+};
+
+#endif // GUITARPASSTHROUGH_MULTIINPUTPASS_H
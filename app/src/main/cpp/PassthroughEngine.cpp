@@ -1,21 +1,49 @@
 #include "PassthroughEngine.h"
 #include <android/log.h>
 #include <thread>
+#include <algorithm>
 
 #define LOG_TAG "PassthroughEngine"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
+// AAudio with small burst duration indicates MMAP, large burst = Legacy AudioTrack/AudioRecord
+static bool detectMMAP(oboe::AudioStream *stream, int32_t sampleRate) {
+    float burstMs = (stream->getFramesPerBurst() * 1000.0f) / sampleRate;
+    return stream->getAudioApi() == oboe::AudioApi::AAudio && burstMs < 5.0f;
+}
+
+// Actual stream latency when available, otherwise a buffer-based estimate
+// scaled up for the extra internal buffering of Legacy mode
+static int32_t estimateLatencyMs(oboe::AudioStream *stream, bool usesMMAP, int32_t legacyMultiplier) {
+    auto result = stream->calculateLatencyMillis();
+    if (result) {
+        return static_cast<int32_t>(result.value());
+    }
+    int32_t frames = stream->getBufferSizeInFrames();
+    int32_t sampleRate = stream->getSampleRate();
+    if (sampleRate > 0) {
+        int32_t bufferLatency = (frames * 1000) / sampleRate;
+        if (!usesMMAP) {
+            bufferLatency *= legacyMultiplier;
+        }
+        return bufferLatency;
+    }
+    return -1;
+}
+
 PassthroughEngine::PassthroughEngine() {
     LOGI("PassthroughEngine created");
 }
 
 PassthroughEngine::~PassthroughEngine() {
+    std::lock_guard<std::mutex> lock(mStateMutex);
     closeStreams();
     LOGI("PassthroughEngine destroyed");
 }
 
 void PassthroughEngine::setEffectOn(bool isOn) {
+    std::lock_guard<std::mutex> lock(mStateMutex);
     if (isOn == mIsEffectOn) {
         return;
     }
@@ -34,10 +62,7 @@ void PassthroughEngine::setEffectOn(bool isOn) {
     }
 }
 
-bool PassthroughEngine::openStreams() {
-    // Create the full-duplex callback first (needed for output stream builder)
-    mFullDuplexPass = std::make_unique<FullDuplexPass>();
-
+bool PassthroughEngine::openOutputStream(oboe::AudioStreamDataCallback *callback) {
     // Create output stream with callback set on builder (stereo output)
     // Try Exclusive mode for potentially lower latency
     oboe::AudioStreamBuilder outputBuilder;
@@ -46,7 +71,7 @@ bool PassthroughEngine::openStreams() {
             ->setSharingMode(oboe::SharingMode::Exclusive)
             ->setPerformanceMode(oboe::PerformanceMode::LowLatency)
             ->setChannelCount(mOutputChannelCount)
-            ->setDataCallback(mFullDuplexPass.get())
+            ->setDataCallback(callback)
             ->setErrorCallback(this);
 
     // Route to specific USB device if set
@@ -58,16 +83,12 @@ bool PassthroughEngine::openStreams() {
     oboe::Result result = outputBuilder.openStream(mOutputStream);
     if (result != oboe::Result::OK) {
         LOGE("Failed to open output stream: %s", oboe::convertToText(result));
-        mFullDuplexPass.reset();
         return false;
     }
 
     // Get the actual sample rate from output stream
     mSampleRate = mOutputStream->getSampleRate();
-
-    // Detect MMAP: AAudio with small burst duration indicates MMAP, large burst = Legacy AudioTrack
-    float outputBurstMs = (mOutputStream->getFramesPerBurst() * 1000.0f) / mSampleRate;
-    mOutputUsesMMAP = (mOutputStream->getAudioApi() == oboe::AudioApi::AAudio && outputBurstMs < 5.0f);
+    mOutputUsesMMAP = detectMMAP(mOutputStream.get(), mSampleRate);
 
     // Set buffer size based on mode:
     // - MMAP: 1x burst for minimum latency
@@ -82,6 +103,21 @@ bool PassthroughEngine::openStreams() {
          mOutputStream->getBufferSizeInFrames(),
          oboe::convertToText(mOutputStream->getAudioApi()),
          mOutputUsesMMAP ? "YES" : "NO");
+    return true;
+}
+
+bool PassthroughEngine::openStreams() {
+    if (isMultiInput()) {
+        return openMultiInputStreams();
+    }
+
+    // Create the full-duplex callback first (needed for output stream builder)
+    mFullDuplexPass = std::make_unique<FullDuplexPass>();
+
+    if (!openOutputStream(mFullDuplexPass.get())) {
+        mFullDuplexPass.reset();
+        return false;
+    }
 
     // Create input stream with matching sample rate (mono input for iRig HD 2)
     // No callback - we read synchronously from the output callback
@@ -96,7 +132,16 @@ bool PassthroughEngine::openStreams() {
             ->setInputPreset(oboe::InputPreset::VoicePerformance)
             ->setErrorCallback(this);
 
-    result = inputBuilder.openStream(mInputStream);
+    if (mInputDeviceIds.size() == 1) {
+        inputBuilder.setDeviceId(mInputDeviceIds[0]);
+        LOGI("Requesting input device ID: %d", mInputDeviceIds[0]);
+    }
+
+    oboe::Result result = inputBuilder.openStream(mInputStream);
+    if (result != oboe::Result::OK && !mInputDeviceIds.empty()) {
+        LOGE("Failed to open input device %d: %s", mInputDeviceIds[0], oboe::convertToText(result));
+        return reopenWithoutInput(0);
+    }
     if (result != oboe::Result::OK) {
         LOGE("Failed to open input stream: %s", oboe::convertToText(result));
         mOutputStream->close();
@@ -109,8 +154,7 @@ bool PassthroughEngine::openStreams() {
     mInputStream->setBufferSizeInFrames(mInputStream->getFramesPerBurst());
 
     // Detect MMAP for input
-    float inputBurstMs = (mInputStream->getFramesPerBurst() * 1000.0f) / mSampleRate;
-    mInputUsesMMAP = (mInputStream->getAudioApi() == oboe::AudioApi::AAudio && inputBurstMs < 5.0f);
+    mInputUsesMMAP = detectMMAP(mInputStream.get(), mSampleRate);
 
     LOGI("Input stream opened: sampleRate=%d, channelCount=%d, framesPerBurst=%d, bufferSize=%d, API=%s, MMAP=%s",
          mInputStream->getSampleRate(),
@@ -123,6 +167,7 @@ bool PassthroughEngine::openStreams() {
     // Set streams on the full-duplex callback
     mFullDuplexPass->setInputStream(mInputStream.get());
     mFullDuplexPass->setOutputStream(mOutputStream.get());
+    mFullDuplexPass->configure();
 
     // Start both streams using FullDuplexStream's coordinated start
     result = mFullDuplexPass->start();
@@ -152,96 +197,289 @@ bool PassthroughEngine::openStreams() {
     return true;
 }
 
+bool PassthroughEngine::openMultiInputStreams() {
+    mMultiInputPass = std::make_unique<MultiInputPass>();
+    for (size_t i = 0; i < mInputDeviceIds.size(); i++) {
+        if (mMultiInputPass->addInput(mInputChannelCount) < 0) {
+            LOGE("Too many input devices, ignoring ID %d", mInputDeviceIds[i]);
+            continue;
+        }
+        mMultiInputPass->getInputChannel(static_cast<int32_t>(i))->setGain(mInputGains[i]);
+        mMultiInputPass->getInputChannel(static_cast<int32_t>(i))->setPan(mInputPans[i]);
+    }
+
+    if (!openOutputStream(mMultiInputPass.get())) {
+        mMultiInputPass.reset();
+        return false;
+    }
+
+    // Each input runs its own callback on its own clock, feeding its buffer in the mixer
+    mInputUsesMMAP = true;
+    for (int32_t i = 0; i < mMultiInputPass->getInputCount(); i++) {
+        oboe::AudioStreamBuilder inputBuilder;
+        inputBuilder.setDirection(oboe::Direction::Input)
+                ->setFormat(oboe::AudioFormat::Float)
+                ->setSharingMode(oboe::SharingMode::Exclusive)
+                ->setPerformanceMode(oboe::PerformanceMode::LowLatency)
+                ->setChannelCount(mInputChannelCount)
+                ->setSampleRate(mSampleRate)
+                ->setDeviceId(mInputDeviceIds[i])
+                // Let Oboe resample devices that can't run at the output rate
+                ->setSampleRateConversionQuality(oboe::SampleRateConversionQuality::Medium)
+                ->setInputPreset(oboe::InputPreset::VoicePerformance)
+                ->setDataCallback(mMultiInputPass->getInputCallback(i))
+                ->setErrorCallback(this);
+
+        std::shared_ptr<oboe::AudioStream> inputStream;
+        oboe::Result result = inputBuilder.openStream(inputStream);
+        if (result != oboe::Result::OK) {
+            LOGE("Failed to open input stream for device %d: %s",
+                 mInputDeviceIds[i], oboe::convertToText(result));
+            return reopenWithoutInput(i);
+        }
+        mInputStreams.push_back(inputStream);
+
+        // A device that was unplugged may silently fall back to the default input
+        if (inputStream->getDeviceId() != mInputDeviceIds[i]) {
+            LOGE("Input device %d not available, got device %d",
+                 mInputDeviceIds[i], inputStream->getDeviceId());
+            return reopenWithoutInput(i);
+        }
+
+        if (inputStream->getChannelCount() != mInputChannelCount) {
+            LOGE("Input device %d opened with %d channels, expected %d",
+                 mInputDeviceIds[i], inputStream->getChannelCount(), mInputChannelCount);
+            return reopenWithoutInput(i);
+        }
+
+        // A mismatched rate would play pitch-shifted and under/overflow constantly
+        if (inputStream->getSampleRate() != mSampleRate) {
+            LOGE("Input device %d opened at %dHz, expected %dHz",
+                 mInputDeviceIds[i], inputStream->getSampleRate(), mSampleRate);
+            return reopenWithoutInput(i);
+        }
+
+        inputStream->setBufferSizeInFrames(inputStream->getFramesPerBurst());
+        bool usesMMAP = detectMMAP(inputStream.get(), mSampleRate);
+        mInputUsesMMAP = mInputUsesMMAP && usesMMAP;
+
+        LOGI("Input %d opened: deviceId=%d, sampleRate=%d, channelCount=%d, framesPerBurst=%d, bufferSize=%d, API=%s, MMAP=%s",
+             i, mInputDeviceIds[i],
+             inputStream->getSampleRate(),
+             inputStream->getChannelCount(),
+             inputStream->getFramesPerBurst(),
+             inputStream->getBufferSizeInFrames(),
+             oboe::convertToText(inputStream->getAudioApi()),
+             usesMMAP ? "YES" : "NO");
+
+        mMultiInputPass->setInputStream(i, inputStream.get());
+    }
+
+    // Set after the inputs are added so their scratch buffers get sized too
+    mMultiInputPass->setOutputStream(mOutputStream.get());
+
+    oboe::Result result = mMultiInputPass->start();
+    if (result != oboe::Result::OK) {
+        LOGE("Failed to start multi-input streams: %s", oboe::convertToText(result));
+        closeStreams();
+        return false;
+    }
+
+    LOGI("Multi-input streams started: %d inputs, input latency %dms, output latency %dms",
+         mMultiInputPass->getInputCount(), getInputLatencyMsLocked(), getOutputLatencyMsLocked());
+    return true;
+}
+
+bool PassthroughEngine::reopenWithoutInput(size_t index) {
+    // Drop an input that can't be opened (typically unplugged) so the remaining
+    // devices keep playing; with one left this falls back to the single-input path
+    LOGI("Dropping input device %d", mInputDeviceIds[index]);
+    closeStreams();
+    mInputDeviceIds.erase(mInputDeviceIds.begin() + index);
+    mInputGains.erase(mInputGains.begin() + index);
+    mInputPans.erase(mInputPans.begin() + index);
+    return openStreams();
+}
+
 void PassthroughEngine::closeStreams() {
     // Stop using FullDuplexStream's coordinated stop
     if (mFullDuplexPass) {
         mFullDuplexPass->stop();
     }
+    if (mMultiInputPass) {
+        mMultiInputPass->stop();
+    }
 
     if (mInputStream) {
         mInputStream->close();
         mInputStream.reset();
     }
 
+    for (auto &inputStream : mInputStreams) {
+        inputStream->close();
+    }
+    mInputStreams.clear();
+
     if (mOutputStream) {
         mOutputStream->close();
         mOutputStream.reset();
     }
 
     mFullDuplexPass.reset();
+    mMultiInputPass.reset();
     LOGI("Streams closed");
 }
 
 void PassthroughEngine::setGain(float gain) {
+    std::lock_guard<std::mutex> lock(mStateMutex);
     if (mFullDuplexPass) {
         mFullDuplexPass->setGain(gain);
         LOGI("Gain set to %.2f", gain);
+    } else if (mMultiInputPass) {
+        mMultiInputPass->setGain(gain);
+        LOGI("Master gain set to %.2f", gain);
     }
 }
 
 void PassthroughEngine::setOutputDeviceId(int32_t deviceId) {
+    std::lock_guard<std::mutex> lock(mStateMutex);
     mOutputDeviceId = deviceId;
     LOGI("Output device ID set to %d", deviceId);
 }
 
+void PassthroughEngine::setInputDeviceIds(const std::vector<int32_t> &deviceIds) {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    mInputDeviceIds = deviceIds;
+    mInputGains.assign(deviceIds.size(), 1.0f);
+    mInputPans.assign(deviceIds.size(), 0.0f);
+    LOGI("Input device IDs set: %zu devices%s", deviceIds.size(),
+         isMultiInput() ? " (multi-input mode)" : "");
+}
+
+int32_t PassthroughEngine::getInputCount() const {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    if (mMultiInputPass) {
+        return mMultiInputPass->getInputCount();
+    }
+    return mInputStream ? 1 : 0;
+}
+
+void PassthroughEngine::setInputGain(int32_t index, float gain) {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    if (index < 0 || index >= static_cast<int32_t>(mInputGains.size())) {
+        return;
+    }
+    mInputGains[index] = gain;
+    if (mMultiInputPass && index < mMultiInputPass->getInputCount()) {
+        mMultiInputPass->getInputChannel(index)->setGain(gain);
+        LOGI("Input %d gain set to %.2f", index, gain);
+    }
+}
+
+void PassthroughEngine::setInputPan(int32_t index, float pan) {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    if (index < 0 || index >= static_cast<int32_t>(mInputPans.size())) {
+        return;
+    }
+    mInputPans[index] = pan;
+    if (mMultiInputPass && index < mMultiInputPass->getInputCount()) {
+        mMultiInputPass->getInputChannel(index)->setPan(pan);
+        LOGI("Input %d pan set to %.2f", index, pan);
+    }
+}
+
+float PassthroughEngine::getInputGain(int32_t index) const {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    if (index < 0 || index >= static_cast<int32_t>(mInputGains.size())) {
+        return 1.0f;
+    }
+    return mInputGains[index];
+}
+
+float PassthroughEngine::getInputPan(int32_t index) const {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    if (index < 0 || index >= static_cast<int32_t>(mInputPans.size())) {
+        return 0.0f;
+    }
+    return mInputPans[index];
+}
+
+int32_t PassthroughEngine::getInputBufferMs(int32_t index) const {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    if (mMultiInputPass && mSampleRate > 0 && index >= 0 && index < mMultiInputPass->getInputCount()) {
+        int32_t frames = mMultiInputPass->getInputChannel(index)->getBufferedFrames();
+        return (frames * 1000) / mSampleRate;
+    }
+    return index == 0 ? getCurrentBufferMsLocked() : -1;
+}
+
+int32_t PassthroughEngine::getInputXRunCount(int32_t index) const {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    if (mMultiInputPass && index >= 0 && index < mMultiInputPass->getInputCount()) {
+        return mMultiInputPass->getInputChannel(index)->getXRunCount();
+    }
+    if (mInputStream && index == 0) {
+        auto result = mInputStream->getXRunCount();
+        return result ? result.value() : -1;
+    }
+    return -1;
+}
+
 bool PassthroughEngine::isInputMMAP() const {
+    std::lock_guard<std::mutex> lock(mStateMutex);
     return mInputUsesMMAP;
 }
 
 bool PassthroughEngine::isOutputMMAP() const {
+    std::lock_guard<std::mutex> lock(mStateMutex);
     return mOutputUsesMMAP;
 }
 
 int32_t PassthroughEngine::getInputLatencyMs() const {
-    if (mInputStream) {
-        // Try to get actual latency from stream
-        auto result = mInputStream->calculateLatencyMillis();
-        if (result) {
-            return static_cast<int32_t>(result.value());
-        }
-        // Fallback to buffer-based estimate
-        int32_t frames = mInputStream->getBufferSizeInFrames();
-        int32_t sampleRate = mInputStream->getSampleRate();
-        if (sampleRate > 0) {
-            int32_t bufferLatency = (frames * 1000) / sampleRate;
-            // Legacy mode adds additional internal buffering
-            if (!mInputUsesMMAP) {
-                bufferLatency *= 2;  // Conservative estimate for Legacy overhead
-            }
-            return bufferLatency;
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    return getInputLatencyMsLocked();
+}
+
+int32_t PassthroughEngine::getInputLatencyMsLocked() const {
+    // Legacy mode adds additional internal buffering (conservative 2x estimate)
+    if (!mInputStreams.empty()) {
+        // Multi-input: report the slowest input
+        int32_t latency = -1;
+        for (const auto &inputStream : mInputStreams) {
+            latency = std::max(latency, estimateLatencyMs(inputStream.get(), mInputUsesMMAP, 2));
         }
+        return latency;
+    }
+    if (mInputStream) {
+        return estimateLatencyMs(mInputStream.get(), mInputUsesMMAP, 2);
     }
     return -1;
 }
 
 int32_t PassthroughEngine::getOutputLatencyMs() const {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    return getOutputLatencyMsLocked();
+}
+
+int32_t PassthroughEngine::getOutputLatencyMsLocked() const {
+    // Legacy mode (AudioTrack) adds significant internal buffering
+    // Typically 2-4x the buffer size for mixing and conversion
     if (mOutputStream) {
-        // Try to get actual latency from stream
-        auto result = mOutputStream->calculateLatencyMillis();
-        if (result) {
-            return static_cast<int32_t>(result.value());
-        }
-        // Fallback to buffer-based estimate
-        int32_t frames = mOutputStream->getBufferSizeInFrames();
-        int32_t sampleRate = mOutputStream->getSampleRate();
-        if (sampleRate > 0) {
-            int32_t bufferLatency = (frames * 1000) / sampleRate;
-            // Legacy mode (AudioTrack) adds significant internal buffering
-            // Typically 2-4x the buffer size for mixing and conversion
-            if (!mOutputUsesMMAP) {
-                bufferLatency *= 3;  // Conservative estimate for Legacy overhead
-            }
-            return bufferLatency;
-        }
+        return estimateLatencyMs(mOutputStream.get(), mOutputUsesMMAP, 3);
     }
     return -1;
 }
 
 void PassthroughEngine::restartStreams() {
     std::lock_guard<std::mutex> lock(mRestartMutex);
+    std::lock_guard<std::mutex> stateLock(mStateMutex);
     if (mIsEffectOn) {
         closeStreams();
+        // Errors from here on belong to the new streams and need their own restart
+        mRestartPending.store(false);
         openStreams();
+    } else {
+        mRestartPending.store(false);
     }
 }
 
@@ -251,7 +489,8 @@ void PassthroughEngine::onErrorBeforeClose(oboe::AudioStream *stream, oboe::Resu
 
 void PassthroughEngine::onErrorAfterClose(oboe::AudioStream *stream, oboe::Result result) {
     LOGE("Stream error after close: %s, restarting...", oboe::convertToText(result));
-    if (result == oboe::Result::ErrorDisconnected) {
+    // Every stream gets disconnected when a device goes away; one restart handles them all
+    if (result == oboe::Result::ErrorDisconnected && !mRestartPending.exchange(true)) {
         // Restart on a separate thread to avoid deadlock
         // Use weak_ptr to prevent use-after-free if engine is destroyed
         std::weak_ptr<PassthroughEngine> weakSelf = shared_from_this();
@@ -264,24 +503,42 @@ void PassthroughEngine::onErrorAfterClose(oboe::AudioStream *stream, oboe::Resul
 }
 
 void PassthroughEngine::setTargetBufferMs(int32_t ms) {
+    std::lock_guard<std::mutex> lock(mStateMutex);
     if (mFullDuplexPass && mSampleRate > 0) {
         int32_t frames = (ms * mSampleRate) / 1000;
         mFullDuplexPass->setTargetBufferFrames(frames);
         LOGI("Target buffer set to %dms (%d frames)", ms, frames);
+    } else if (mMultiInputPass && mSampleRate > 0) {
+        int32_t frames = (ms * mSampleRate) / 1000;
+        mMultiInputPass->setTargetBufferFrames(frames);
+        LOGI("Target buffer set to %dms (%d frames) on all inputs", ms, frames);
     }
 }
 
 void PassthroughEngine::setDrainRate(float rate) {
+    std::lock_guard<std::mutex> lock(mStateMutex);
     if (mFullDuplexPass) {
         mFullDuplexPass->setDrainRate(rate);
         LOGI("Drain rate set to %.2f", rate);
+    } else if (mMultiInputPass) {
+        mMultiInputPass->setDrainRate(rate);
+        LOGI("Drain rate set to %.2f on all inputs", rate);
     }
 }
 
 int32_t PassthroughEngine::getCurrentBufferMs() const {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    return getCurrentBufferMsLocked();
+}
+
+int32_t PassthroughEngine::getCurrentBufferMsLocked() const {
     if (mFullDuplexPass && mSampleRate > 0) {
         int32_t frames = mFullDuplexPass->getCurrentBufferFrames();
         return (frames * 1000) / mSampleRate;
     }
+    if (mMultiInputPass && mSampleRate > 0) {
+        int32_t frames = mMultiInputPass->getCurrentBufferFrames();
+        return (frames * 1000) / mSampleRate;
+    }
     return -1;
 }
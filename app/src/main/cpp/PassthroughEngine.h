@@ -3,7 +3,11 @@
 
 #include <oboe/Oboe.h>
 #include <memory>
+#include <vector>
+#include <atomic>
+#include <mutex>
 #include "FullDuplexPass.h"
+#include "MultiInputPass.h"
 
 class PassthroughEngine : public oboe::AudioStreamErrorCallback,
                           public std::enable_shared_from_this<PassthroughEngine> {
@@ -15,6 +19,18 @@ public:
     void setGain(float gain);
     void setOutputDeviceId(int32_t deviceId);
 
+    // Multi-input mode: two or more device IDs mix every input into the one output.
+    // Takes effect on the next stream open. A single ID just routes the normal input.
+    void setInputDeviceIds(const std::vector<int32_t> &deviceIds);
+    int32_t getInputCount() const;
+    void setInputGain(int32_t index, float gain);
+    void setInputPan(int32_t index, float pan);
+    // Settings survive restarts and follow their device when another input is dropped
+    float getInputGain(int32_t index) const;
+    float getInputPan(int32_t index) const;
+    int32_t getInputBufferMs(int32_t index) const;
+    int32_t getInputXRunCount(int32_t index) const;
+
     bool isInputMMAP() const;
     bool isOutputMMAP() const;
     int32_t getInputLatencyMs() const;
@@ -30,14 +46,30 @@ public:
     void onErrorAfterClose(oboe::AudioStream *stream, oboe::Result result) override;
 
 private:
+    void restartStreams();
+
+    // Callers hold mStateMutex
     bool openStreams();
+    bool openMultiInputStreams();
+    bool openOutputStream(oboe::AudioStreamDataCallback *callback);
+    bool reopenWithoutInput(size_t index);
     void closeStreams();
-    void restartStreams();
+    bool isMultiInput() const { return mInputDeviceIds.size() > 1; }
+    int32_t getCurrentBufferMsLocked() const;
+    int32_t getInputLatencyMsLocked() const;
+    int32_t getOutputLatencyMsLocked() const;
 
     std::shared_ptr<oboe::AudioStream> mInputStream;
     std::shared_ptr<oboe::AudioStream> mOutputStream;
     std::unique_ptr<FullDuplexPass> mFullDuplexPass;
 
+    // Multi-input mode
+    std::vector<std::shared_ptr<oboe::AudioStream>> mInputStreams;
+    std::unique_ptr<MultiInputPass> mMultiInputPass;
+    std::vector<int32_t> mInputDeviceIds;
+    std::vector<float> mInputGains;
+    std::vector<float> mInputPans;
+
     int32_t mSampleRate = oboe::kUnspecified;
     int32_t mInputChannelCount = oboe::ChannelCount::Mono;  // iRig HD 2 is mono
     int32_t mOutputChannelCount = oboe::ChannelCount::Stereo;
@@ -45,7 +77,11 @@ private:
     bool mInputUsesMMAP = false;
     bool mOutputUsesMMAP = false;
     bool mIsEffectOn = false;
+    // Guards the streams, passes and per-input settings above: a restart thread
+    // replaces them while the UI polls through JNI
+    mutable std::mutex mStateMutex;
     std::mutex mRestartMutex;
+    std::atomic<bool> mRestartPending{false};
 };
 
 #endif // GUITARPASSTHROUGH_PASSTHROUGHENGINE_H
@@ -0,0 +1,20 @@
+#ifndef GUITARPASSTHROUGH_SOFTCLAMP_H
+#define GUITARPASSTHROUGH_SOFTCLAMP_H
+
+// Soft clamp using cubic saturation to prevent hard clipping
+// Keeps signal in -1.0 to 1.0 range with smooth limiting
+// Polynomial approximation avoids expensive tanhf in the audio callback
+inline float softClamp(float x) {
+    if (x > 1.0f) return 1.0f;
+    if (x < -1.0f) return -1.0f;
+    if (x > 0.9f) {
+        float t = (x - 0.9f) * 10.0f;  // normalize 0.9..1.0+ to 0..1
+        return 0.9f + 0.1f * t / (1.0f + t);  // rational saturation
+    } else if (x < -0.9f) {
+        float t = (-x - 0.9f) * 10.0f;
+        return -0.9f - 0.1f * t / (1.0f + t);
+    }
+    return x;
+}
+
+#endif // GUITARPASSTHROUGH_SOFTCLAMP_H
@@ -0,0 +1,97 @@
+#ifndef GUITARPASSTHROUGH_SPSCRINGBUFFER_H
+#define GUITARPASSTHROUGH_SPSCRINGBUFFER_H
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Lock-free single-producer / single-consumer ring of interleaved float frames.
+// The producer is an input stream callback, the consumer is the output callback.
+// No Oboe dependency so it can be exercised on the host with simulated streams.
+class SpscRingBuffer {
+public:
+    // Capacity is rounded up to a power of two so wrap-around is a mask
+    SpscRingBuffer(int32_t capacityFrames, int32_t channelCount)
+            : mChannelCount(std::max(channelCount, 1)) {
+        int32_t capacity = 1;
+        while (capacity < capacityFrames) capacity <<= 1;
+        mCapacityFrames = capacity;
+        mMask = capacity - 1;
+        mData.resize(static_cast<size_t>(capacity) * mChannelCount);
+    }
+
+    int32_t getCapacityFrames() const { return mCapacityFrames; }
+    int32_t getChannelCount() const { return mChannelCount; }
+
+    // Safe to call from either side; the value may be stale by the time it is used
+    int32_t getAvailableFrames() const {
+        uint64_t writeIndex = mWriteIndex.load(std::memory_order_acquire);
+        uint64_t readIndex = mReadIndex.load(std::memory_order_acquire);
+        return static_cast<int32_t>(writeIndex - readIndex);
+    }
+
+    // Producer side. Returns frames actually written (less than numFrames when full).
+    int32_t write(const float *frames, int32_t numFrames) {
+        uint64_t writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+        uint64_t readIndex = mReadIndex.load(std::memory_order_acquire);
+        int32_t space = mCapacityFrames - static_cast<int32_t>(writeIndex - readIndex);
+        int32_t toWrite = std::min(numFrames, space);
+        if (toWrite <= 0) return 0;
+
+        int32_t start = static_cast<int32_t>(writeIndex & mMask);
+        int32_t firstPart = std::min(toWrite, mCapacityFrames - start);
+        memcpy(&mData[start * mChannelCount], frames,
+               firstPart * mChannelCount * sizeof(float));
+        if (toWrite > firstPart) {
+            memcpy(&mData[0], frames + firstPart * mChannelCount,
+                   (toWrite - firstPart) * mChannelCount * sizeof(float));
+        }
+
+        mWriteIndex.store(writeIndex + toWrite, std::memory_order_release);
+        return toWrite;
+    }
+
+    // Consumer side. Returns frames actually read (less than numFrames when empty).
+    int32_t read(float *frames, int32_t numFrames) {
+        uint64_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+        uint64_t writeIndex = mWriteIndex.load(std::memory_order_acquire);
+        int32_t toRead = std::min(numFrames, static_cast<int32_t>(writeIndex - readIndex));
+        if (toRead <= 0) return 0;
+
+        int32_t start = static_cast<int32_t>(readIndex & mMask);
+        int32_t firstPart = std::min(toRead, mCapacityFrames - start);
+        memcpy(frames, &mData[start * mChannelCount],
+               firstPart * mChannelCount * sizeof(float));
+        if (toRead > firstPart) {
+            memcpy(frames + firstPart * mChannelCount, &mData[0],
+                   (toRead - firstPart) * mChannelCount * sizeof(float));
+        }
+
+        mReadIndex.store(readIndex + toRead, std::memory_order_release);
+        return toRead;
+    }
+
+    // Consumer side. Drops the oldest frames without copying them out.
+    int32_t skip(int32_t numFrames) {
+        uint64_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+        uint64_t writeIndex = mWriteIndex.load(std::memory_order_acquire);
+        int32_t toSkip = std::min(numFrames, static_cast<int32_t>(writeIndex - readIndex));
+        if (toSkip <= 0) return 0;
+        mReadIndex.store(readIndex + toSkip, std::memory_order_release);
+        return toSkip;
+    }
+
+private:
+    std::vector<float> mData;
+    int32_t mChannelCount;
+    int32_t mCapacityFrames = 0;
+    int32_t mMask = 0;
+
+    // Separate cache lines so producer and consumer don't false-share
+    alignas(64) std::atomic<uint64_t> mWriteIndex{0};
+    alignas(64) std::atomic<uint64_t> mReadIndex{0};
+};
+
+#endif // GUITARPASSTHROUGH_SPSCRINGBUFFER_H
@@ -0,0 +1,277 @@
+// Per-callback cost of FullDuplexPass at 48-frame MMAP bursts, compared with the
+// per-burst-query callback it replaced (LegacyPass below, kept as a baseline).
+//
+// The stub streams charge a configurable cost for every stream query so the
+// saving can be read against realistic AAudio call costs, not just no-op calls.
+// Runs once with draining off and once with it on:
+//   callback_benchmark [callbacks]
+
+#include "FullDuplexPass.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+static int32_t sQuerySpins = 0;
+
+// Burns roughly the configured time per stream query
+__attribute__((noinline)) static void queryCost() {
+    for (volatile int32_t i = 0; i < sQuerySpins; i = i + 1) {}
+}
+
+class SimulatedStream : public oboe::AudioStream {
+public:
+    explicit SimulatedStream(int32_t channelCount) : mChannelCount(channelCount) {}
+
+    // Input level reported to the drain logic
+    void setAvailableFrames(int32_t frames) { mAvailableFrames = frames; }
+
+    int32_t getChannelCount() const override { queryCost(); return mChannelCount; }
+    int32_t getSampleRate() const override { queryCost(); return 48000; }
+    oboe::ResultWithValue<int32_t> getXRunCount() override { queryCost(); return 0; }
+    oboe::ResultWithValue<int32_t> getAvailableFrames() override { queryCost(); return mAvailableFrames; }
+    oboe::ResultWithValue<int32_t> read(void *buffer, int32_t numFrames, int64_t) override {
+        float *floats = static_cast<float *>(buffer);
+        for (int32_t i = 0; i < numFrames * mChannelCount; i++) floats[i] = 0.01f * (i & 7);
+        return numFrames;
+    }
+
+private:
+    int32_t mChannelCount;
+    int32_t mAvailableFrames = 48;
+};
+
+// The callback as it was before stream-open specialization (FullDuplexPass at
+// 93d6c23, onAudioReady copied verbatim): queries both streams and re-branches on
+// layout and drain mode every burst. Logging compiles to the stub's no-op.
+class LegacyPass : public oboe::AudioStreamDataCallback {
+public:
+    void setInputStream(oboe::AudioStream *stream) { mInputStream = stream; }
+    void setTargetBufferFrames(int32_t frames) { mTargetBufferFrames.store(frames, std::memory_order_relaxed); }
+    void setDrainRate(float rate) { mDrainRate.store(rate, std::memory_order_relaxed); }
+
+    oboe::DataCallbackResult onAudioReady(
+            oboe::AudioStream *outputStream,
+            void *audioData,
+            int32_t numFrames) override {
+
+        mCallbackCount++;
+        float *outputFloats = static_cast<float *>(audioData);
+        int32_t outputChannelCount = outputStream->getChannelCount();
+
+        // Check for XRuns (buffer underruns/overruns)
+        if (mInputStream) {
+            auto inputXRunResult = mInputStream->getXRunCount();
+            if (inputXRunResult && inputXRunResult.value() > mInputXRunCount) {
+                FDP_LOGW("Input XRun detected! Total: %d", inputXRunResult.value());
+                mInputXRunCount = inputXRunResult.value();
+            }
+        }
+        auto outputXRunResult = outputStream->getXRunCount();
+        if (outputXRunResult && outputXRunResult.value() > mOutputXRunCount) {
+            FDP_LOGW("Output XRun detected! Total: %d", outputXRunResult.value());
+            mOutputXRunCount = outputXRunResult.value();
+        }
+
+        if (!mInputStream) {
+            // No input, fill with silence
+            memset(outputFloats, 0, numFrames * outputChannelCount * sizeof(float));
+            return oboe::DataCallbackResult::Continue;
+        }
+
+        int32_t inputChannelCount = mInputStream->getChannelCount();
+
+        // Load atomic tuning parameters once per callback
+        float drainRate = mDrainRate.load(std::memory_order_relaxed);
+        int32_t targetBufferFrames = mTargetBufferFrames.load(std::memory_order_relaxed);
+        float gain = mGain.load(std::memory_order_relaxed);
+
+        // Check how many frames are available
+        auto availResult = mInputStream->getAvailableFrames();
+        int32_t availableFrames = availResult ? availResult.value() : 0;
+        mLastAvailableFrames.store(availableFrames, std::memory_order_relaxed);
+
+        // Calculate how many frames to read
+        // Base: numFrames (what output needs)
+        // Extra: if buffer is over target and draining is enabled, read more to gradually reduce
+        int32_t framesToRead = numFrames;
+        int32_t framesDrained = 0;
+
+        if (drainRate > 0.0f && targetBufferFrames > 0) {
+            int32_t excessFrames = availableFrames - targetBufferFrames;
+            if (excessFrames > 0) {
+                // Gradually drain: read extra frames based on drain rate
+                // drainRate 0.5 = read 50% extra, 1.0 = read double
+                int32_t extraFrames = static_cast<int32_t>(numFrames * drainRate);
+                // Don't drain more than the excess
+                extraFrames = std::min(extraFrames, excessFrames);
+                framesToRead = numFrames + extraFrames;
+                framesDrained = extraFrames;
+            }
+        }
+
+        // Ensure buffer is large enough
+        int32_t inputSamplesNeeded = framesToRead * inputChannelCount;
+        if (mInputBuffer.size() < static_cast<size_t>(inputSamplesNeeded)) {
+            mInputBuffer.resize(inputSamplesNeeded);
+        }
+
+        // Read frames (including any extra for draining)
+        auto readResult = mInputStream->read(mInputBuffer.data(), framesToRead, 0);
+
+        int32_t framesRead = 0;
+        if (readResult && readResult.value() > 0) {
+            framesRead = readResult.value();
+            mTotalFramesRead += framesRead;
+            if (framesDrained > 0) {
+                mFramesDrained += std::min(framesDrained, framesRead - numFrames);
+            }
+        }
+
+        // Calculate which frames to use for output
+        // If we read more than needed, use the NEWEST frames (skip oldest)
+        int32_t framesToSkip = 0;
+        int32_t framesToUse = framesRead;
+        if (framesRead > numFrames) {
+            framesToSkip = framesRead - numFrames;
+            framesToUse = numFrames;
+        }
+
+        // Log periodically (every ~1 second at 48kHz with 240 frame bursts)
+        if (mCallbackCount % 200 == 0) {
+            int32_t bufferLatencyMs = (availableFrames * 1000) / mInputStream->getSampleRate();
+            FDP_LOGI("Callback #%d: avail=%d (%dms), read=%d, skip=%d, target=%d, drain=%.1f",
+                     mCallbackCount, availableFrames, bufferLatencyMs, framesRead,
+                     framesToSkip, targetBufferFrames, drainRate);
+        }
+
+        mTotalFramesWritten += numFrames;
+
+        // Process audio: mono to stereo with gain and soft limiting
+        // When draining, skip oldest frames and use newest (framesToSkip offset)
+        if (inputChannelCount == 1 && outputChannelCount == 2) {
+            for (int i = 0; i < framesToUse; i++) {
+                // Use frames starting at framesToSkip (newest frames)
+                float sample = mInputBuffer[i + framesToSkip] * gain;
+                // Soft clamp to prevent hard clipping distortion
+                sample = softClamp(sample);
+                outputFloats[i * 2] = sample;
+                outputFloats[i * 2 + 1] = sample;
+            }
+            // Fill remaining with silence
+            for (int i = framesToUse; i < numFrames; i++) {
+                outputFloats[i * 2] = 0.0f;
+                outputFloats[i * 2 + 1] = 0.0f;
+            }
+        } else if (inputChannelCount == outputChannelCount) {
+            int32_t skipSamples = framesToSkip * inputChannelCount;
+            for (int i = 0; i < framesToUse * outputChannelCount; i++) {
+                float sample = mInputBuffer[i + skipSamples] * gain;
+                outputFloats[i] = softClamp(sample);
+            }
+            for (int i = framesToUse * outputChannelCount; i < numFrames * outputChannelCount; i++) {
+                outputFloats[i] = 0.0f;
+            }
+        } else {
+            // Fallback: fill with silence
+            memset(outputFloats, 0, numFrames * outputChannelCount * sizeof(float));
+        }
+
+        return oboe::DataCallbackResult::Continue;
+    }
+
+private:
+    oboe::AudioStream *mInputStream = nullptr;
+    std::atomic<float> mGain{8.0f};
+    std::vector<float> mInputBuffer;
+
+    // Latency tuning (atomic for cross-thread access from UI and audio callback)
+    std::atomic<int32_t> mTargetBufferFrames{0};  // 0 = disabled (no draining)
+    std::atomic<float> mDrainRate{0.0f};           // 0 = disabled, 0.5 = gradual, 1.0 = aggressive
+    std::atomic<int32_t> mLastAvailableFrames{0};  // For UI display
+
+    // Statistics
+    int32_t mCallbackCount = 0;
+    int64_t mTotalFramesRead = 0;
+    int64_t mTotalFramesWritten = 0;
+    int64_t mFramesDrained = 0;
+    int32_t mInputXRunCount = 0;
+    int32_t mOutputXRunCount = 0;
+};
+
+static double nanosPerCallback(oboe::AudioStreamDataCallback *callback, oboe::AudioStream *output,
+                               int32_t callbacks) {
+    float buffer[48 * 2];
+    for (int32_t i = 0; i < callbacks / 10; i++) callback->onAudioReady(output, buffer, 48);  // warm up
+
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < callbacks; i++) callback->onAudioReady(output, buffer, 48);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / callbacks;
+}
+
+// Spin count that takes about targetNanos
+static int32_t calibrateSpins(double targetNanos) {
+    if (targetNanos <= 0.0) return 0;
+    // Best of several runs so a preemption doesn't inflate the estimate
+    sQuerySpins = 100000;
+    double nanosPerSpin = 1e9;
+    for (int32_t run = 0; run < 20; run++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < 10; i++) queryCost();
+        auto end = std::chrono::steady_clock::now();
+        nanosPerSpin = std::min(nanosPerSpin,
+                                std::chrono::duration<double, std::nano>(end - start).count() / (10.0 * sQuerySpins));
+    }
+    return std::max(1, static_cast<int32_t>(targetNanos / nanosPerSpin));
+}
+
+// What one query actually costs at the current spin count, measured the way
+// the callbacks call it (short, repeated calls)
+static double measureQueryNanos() {
+    const int32_t calls = 200000;
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < calls; i++) queryCost();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / calls;
+}
+
+int main(int argc, char **argv) {
+    int32_t callbacks = argc > 1 ? atoi(argv[1]) : 2000000;
+    SimulatedStream input(1);
+    SimulatedStream output(2);
+
+    // Draining on: a 48-frame target with 96 frames queued reads 72 frames per burst
+    for (bool drain : {false, true}) {
+        input.setAvailableFrames(drain ? 96 : 48);
+
+        printf("%s48-frame mono->stereo callbacks, %s, %d callbacks per run\n", drain ? "\n" : "",
+               drain ? "draining on (target 48, rate 0.5)" : "no draining", callbacks);
+        printf("%-16s %14s %14s %10s\n", "query cost (ns)", "legacy (ns)", "specialized", "saved");
+        printf("(query cost is measured; legacy makes 5 stream queries per burst, specialized %s)\n",
+               drain ? "1 per burst plus 2 per 64 bursts" : "3 per 64 bursts");
+
+        for (double queryNanos : {0.0, 25.0, 100.0, 250.0}) {
+            sQuerySpins = calibrateSpins(queryNanos);
+            double measuredQueryNanos = measureQueryNanos();
+
+            LegacyPass legacy;
+            legacy.setInputStream(&input);
+            FullDuplexPass specialized;
+            specialized.setInputStream(&input);
+            specialized.setOutputStream(&output);
+            specialized.configure();
+            if (drain) {
+                legacy.setTargetBufferFrames(48);
+                legacy.setDrainRate(0.5f);
+                specialized.setTargetBufferFrames(48);
+                specialized.setDrainRate(0.5f);
+            }
+
+            double legacyNanos = nanosPerCallback(&legacy, &output, callbacks);
+            double specializedNanos = nanosPerCallback(&specialized, &output, callbacks);
+            printf("%-16.1f %14.1f %14.1f %9.1f%%\n", measuredQueryNanos, legacyNanos, specializedNanos,
+                   100.0 * (legacyNanos - specializedNanos) / legacyNanos);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,338 @@
+// Host tests for SpscRingBuffer, InputChannel, MixingBus and MultiInputPass.
+// Input devices are simulated by pushing bursts at a rate slightly off the
+// output rate, the way two USB interfaces on separate clocks would behave.
+
+#include "SpscRingBuffer.h"
+#include "InputChannel.h"
+#include "MixingBus.h"
+#include "MultiInputPass.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+static int sFailures = 0;
+
+#define EXPECT(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: EXPECT(%s) failed\n", __FILE__, __LINE__, #cond); \
+            sFailures++; \
+        } \
+    } while (0)
+
+#define EXPECT_NEAR(a, b, eps) EXPECT(std::fabs((a) - (b)) <= (eps))
+
+static constexpr int32_t kOutputRate = 48000;
+static constexpr int32_t kBurstFrames = 48;  // 1ms MMAP burst
+static constexpr int32_t kCapacityFrames = 4096;
+
+struct DriftResult {
+    int32_t maxBufferedFrames = 0;
+    int32_t finalBufferedFrames = 0;
+};
+
+// Runs `seconds` of output callbacks while an input at inputRate pushes bursts
+// of inputBurstFrames
+static DriftResult simulateDrift(InputChannel &channel, double inputRate, int32_t seconds,
+                                 int32_t targetBufferFrames, float drainRate,
+                                 int32_t inputBurstFrames = kBurstFrames) {
+    std::vector<float> input(inputBurstFrames * channel.getChannelCount(), 0.25f);
+    std::vector<float> output(kBurstFrames * channel.getChannelCount());
+    double produced = 0.0;
+    DriftResult result;
+
+    int32_t callbacks = seconds * kOutputRate / kBurstFrames;
+    for (int32_t i = 0; i < callbacks; i++) {
+        produced += kBurstFrames * inputRate / kOutputRate;
+        while (produced >= inputBurstFrames) {
+            channel.push(input.data(), inputBurstFrames);
+            produced -= inputBurstFrames;
+        }
+        channel.pull(output.data(), kBurstFrames, targetBufferFrames, drainRate);
+        result.maxBufferedFrames = std::max(result.maxBufferedFrames, channel.getBufferedFrames());
+    }
+    result.finalBufferedFrames = channel.getBufferedFrames();
+    return result;
+}
+
+static void testRingWrapAround() {
+    SpscRingBuffer ring(6, 2);  // rounded up to 8 frames
+    EXPECT(ring.getCapacityFrames() == 8);
+
+    float frames[16];
+    float out[16];
+    int32_t next = 0;
+    int32_t expected = 0;
+    // Odd-sized writes and reads walk the indices across the wrap point many times
+    for (int32_t round = 0; round < 100; round++) {
+        for (int32_t i = 0; i < 5 * 2; i++) frames[i] = static_cast<float>(next++);
+        EXPECT(ring.write(frames, 5) == 5);
+        EXPECT(ring.getAvailableFrames() == 5);
+        EXPECT(ring.read(out, 5) == 5);
+        for (int32_t i = 0; i < 5 * 2; i++) EXPECT(out[i] == static_cast<float>(expected++));
+    }
+
+    // Full and empty edges
+    for (int32_t i = 0; i < 16; i++) frames[i] = 1.0f;
+    EXPECT(ring.write(frames, 8) == 8);
+    EXPECT(ring.write(frames, 1) == 0);
+    EXPECT(ring.skip(3) == 3);
+    EXPECT(ring.read(out, 8) == 5);
+    EXPECT(ring.read(out, 1) == 0);
+}
+
+static void testFastSourceWithoutDrainSettings() {
+    InputChannel channel(kCapacityFrames, 1);
+    channel.setDefaultTargetFrames(kBurstFrames * 2);
+    DriftResult result = simulateDrift(channel, 48100.0, 60, 0, 0.0f);
+
+    // Bounded near the default target instead of filling the buffer
+    EXPECT(result.finalBufferedFrames <= kBurstFrames * 4);
+    EXPECT(channel.getOverflowCount() == 0);
+    EXPECT(channel.getFramesDrained() > 0);
+}
+
+static void testFastSourceWithDrainRateButNoTarget() {
+    InputChannel channel(kCapacityFrames, 1);
+    channel.setDefaultTargetFrames(kBurstFrames * 2);
+    DriftResult result = simulateDrift(channel, 48100.0, 60, 0, 0.5f);
+
+    EXPECT(result.finalBufferedFrames <= kBurstFrames * 4);
+    EXPECT(channel.getOverflowCount() == 0);
+}
+
+static void testFastSourceWithDrainSettings() {
+    InputChannel channel(kCapacityFrames, 2);
+    channel.setDefaultTargetFrames(kBurstFrames * 2);
+    int32_t target = 480;  // 10ms
+    DriftResult result = simulateDrift(channel, 48200.0, 30, target, 1.0f);
+
+    EXPECT(result.maxBufferedFrames <= target + kBurstFrames * 2);
+    EXPECT(channel.getOverflowCount() == 0);
+    EXPECT(channel.getUnderrunCount() == 0);
+}
+
+static void testSlowSourceReprimes() {
+    InputChannel channel(kCapacityFrames, 1);
+    channel.setDefaultTargetFrames(kBurstFrames * 2);
+    std::vector<float> output(kBurstFrames);
+
+    // Not primed yet: silence until a burst plus the target is queued
+    std::vector<float> input(kBurstFrames, 0.5f);
+    channel.push(input.data(), kBurstFrames);
+    EXPECT(channel.pull(output.data(), kBurstFrames, 0, 0.0f) == 0);
+    EXPECT(output[0] == 0.0f);
+    channel.push(input.data(), kBurstFrames);
+    channel.push(input.data(), kBurstFrames);
+    EXPECT(channel.pull(output.data(), kBurstFrames, 0, 0.0f) == kBurstFrames);
+    EXPECT(output[0] == 0.5f);
+
+    // A slow source eventually runs dry; each underrun re-primes instead of
+    // crackling on every burst, so underruns stay rare
+    DriftResult result = simulateDrift(channel, 47900.0, 60, 0, 0.0f);
+    int32_t underruns = channel.getUnderrunCount();
+    EXPECT(underruns > 0);
+    // 100 frames/s deficit refilled 96+ frames per re-prime: about one per second
+    EXPECT(underruns <= 70);
+    EXPECT(result.maxBufferedFrames <= kBurstFrames * 4);
+    EXPECT(channel.getOverflowCount() == 0);
+}
+
+static void testInputBurstLargerThanOutputBurst() {
+    // Common USB input bursts against a 48-frame MMAP output
+    for (int32_t inputBurst : {192, 240, 480}) {
+        InputChannel channel(kCapacityFrames, 1);
+        channel.setInputBurstFrames(inputBurst);
+        channel.setDefaultTargetFrames(InputChannel::defaultTargetFrames(kBurstFrames, inputBurst));
+        DriftResult result = simulateDrift(channel, kOutputRate, 30, 0, 0.0f, inputBurst);
+
+        // Same clock: the sawtooth of big pushes is not drift
+        EXPECT(channel.getUnderrunCount() == 0);
+        EXPECT(channel.getFramesDrained() == 0);
+        EXPECT(channel.getOverflowCount() == 0);
+        EXPECT(result.maxBufferedFrames <= kBurstFrames * 2 + inputBurst * 2);
+
+        // A fast source with big bursts is still trimmed
+        InputChannel fast(kCapacityFrames, 1);
+        fast.setInputBurstFrames(inputBurst);
+        fast.setDefaultTargetFrames(InputChannel::defaultTargetFrames(kBurstFrames, inputBurst));
+        result = simulateDrift(fast, 48100.0, 60, 0, 0.0f, inputBurst);
+        EXPECT(fast.getFramesDrained() > 0);
+        EXPECT(fast.getUnderrunCount() == 0);
+        EXPECT(result.finalBufferedFrames <= kBurstFrames * 2 + inputBurst * 2);
+    }
+}
+
+static void testPanAndGainSumming() {
+    float gainLeft, gainRight;
+    MixingBus::panGains(2.0f, 0.0f, gainLeft, gainRight);
+    EXPECT_NEAR(gainLeft, 2.0f, 1e-6f);
+    EXPECT_NEAR(gainRight, 2.0f, 1e-6f);
+    MixingBus::panGains(1.0f, -1.0f, gainLeft, gainRight);
+    EXPECT_NEAR(gainLeft, 1.0f, 1e-6f);
+    EXPECT_NEAR(gainRight, 0.0f, 1e-6f);
+    MixingBus::panGains(1.0f, 0.5f, gainLeft, gainRight);
+    EXPECT_NEAR(gainLeft, 0.5f, 1e-6f);
+    EXPECT_NEAR(gainRight, 1.0f, 1e-6f);
+
+    const int32_t numFrames = 4;
+    std::vector<float> mono = {0.1f, 0.2f, 0.3f, 0.4f};
+    std::vector<float> stereo = {0.1f, -0.1f, 0.1f, -0.1f, 0.1f, -0.1f, 0.1f, -0.1f};
+
+    MixingBus bus;
+    bus.prepare(numFrames);
+    bus.clear(numFrames);
+    MixingBus::panGains(1.0f, -1.0f, gainLeft, gainRight);  // mono hard left
+    bus.add(mono.data(), 1, numFrames, gainLeft, gainRight);
+    MixingBus::panGains(0.5f, 0.0f, gainLeft, gainRight);   // stereo centered, half gain
+    bus.add(stereo.data(), 2, numFrames, gainLeft, gainRight);
+
+    std::vector<float> out(numFrames * 2);
+    bus.render(out.data(), 2, numFrames, 2.0f);
+    for (int32_t i = 0; i < numFrames; i++) {
+        EXPECT_NEAR(out[i * 2], (mono[i] + 0.05f) * 2.0f, 1e-5f);
+        EXPECT_NEAR(out[i * 2 + 1], -0.1f, 1e-5f);
+    }
+
+    // Mono output folds both sides down
+    std::vector<float> monoOut(numFrames);
+    bus.render(monoOut.data(), 1, numFrames, 2.0f);
+    for (int32_t i = 0; i < numFrames; i++) {
+        EXPECT_NEAR(monoOut[i], (out[i * 2] + out[i * 2 + 1]) * 0.5f, 1e-5f);
+    }
+
+    // Loud sums are soft-limited rather than clipped past full scale
+    bus.clear(numFrames);
+    bus.add(mono.data(), 1, numFrames, 10.0f, 10.0f);
+    bus.render(out.data(), 2, numFrames, 1.0f);
+    for (float sample : out) EXPECT(sample <= 1.0f && sample >= -1.0f);
+}
+
+static void testTwoInputsAtDifferentRates() {
+    InputChannel guitar(kCapacityFrames, 1);
+    InputChannel mic(kCapacityFrames, 2);
+    guitar.setDefaultTargetFrames(kBurstFrames * 2);
+    mic.setDefaultTargetFrames(kBurstFrames * 2);
+    guitar.setPan(-1.0f);
+    mic.setPan(1.0f);
+
+    std::vector<float> guitarIn(kBurstFrames, 0.2f);
+    std::vector<float> micIn(kBurstFrames * 2, 0.3f);
+    std::vector<float> scratch(kBurstFrames * 2);
+    std::vector<float> out(kBurstFrames * 2);
+    MixingBus bus;
+    bus.prepare(kBurstFrames);
+
+    double guitarProduced = 0.0, micProduced = 0.0;
+    int32_t callbacks = 30 * kOutputRate / kBurstFrames;
+    for (int32_t i = 0; i < callbacks; i++) {
+        guitarProduced += kBurstFrames * 48050.0 / kOutputRate;
+        micProduced += kBurstFrames * 47970.0 / kOutputRate;
+        while (guitarProduced >= kBurstFrames) { guitar.push(guitarIn.data(), kBurstFrames); guitarProduced -= kBurstFrames; }
+        while (micProduced >= kBurstFrames) { mic.push(micIn.data(), kBurstFrames); micProduced -= kBurstFrames; }
+
+        bus.clear(kBurstFrames);
+        float gainLeft, gainRight;
+        guitar.pull(scratch.data(), kBurstFrames, 0, 0.0f);
+        MixingBus::panGains(guitar.getGain(), guitar.getPan(), gainLeft, gainRight);
+        bus.add(scratch.data(), 1, kBurstFrames, gainLeft, gainRight);
+        mic.pull(scratch.data(), kBurstFrames, 0, 0.0f);
+        MixingBus::panGains(mic.getGain(), mic.getPan(), gainLeft, gainRight);
+        bus.add(scratch.data(), 2, kBurstFrames, gainLeft, gainRight);
+        bus.render(out.data(), 2, kBurstFrames, 1.0f);
+    }
+
+    EXPECT(guitar.getBufferedFrames() <= kBurstFrames * 4);
+    EXPECT(mic.getBufferedFrames() <= kBurstFrames * 4);
+    EXPECT(guitar.getOverflowCount() == 0);
+    EXPECT(mic.getOverflowCount() == 0);
+    // Each input stays on its own side
+    EXPECT_NEAR(out[0], 0.2f, 1e-5f);
+}
+
+// Stream stand-in for driving MultiInputPass callbacks directly
+class FakeStream : public oboe::AudioStream {
+public:
+    FakeStream(int32_t channelCount, int32_t framesPerBurst)
+            : mChannelCount(channelCount), mFramesPerBurst(framesPerBurst) {}
+    int32_t getChannelCount() const override { return mChannelCount; }
+    int32_t getFramesPerBurst() const override { return mFramesPerBurst; }
+
+private:
+    int32_t mChannelCount;
+    int32_t mFramesPerBurst;
+};
+
+static void testMultiInputPassCallbacks() {
+    FakeStream guitarStream(1, 192);
+    FakeStream micStream(2, 48);
+    FakeStream outputStream(2, kBurstFrames);
+
+    MultiInputPass pass;
+    EXPECT(pass.addInput(1) == 0);
+    EXPECT(pass.addInput(2) == 1);
+    pass.setInputStream(0, &guitarStream);
+    pass.setInputStream(1, &micStream);
+    pass.setOutputStream(&outputStream);
+    pass.setGain(1.0f);
+    pass.getInputChannel(0)->setPan(-1.0f);
+    pass.getInputChannel(1)->setPan(1.0f);
+    pass.getInputChannel(1)->setGain(0.5f);
+
+    EXPECT(pass.getInputChannel(0)->getDefaultTargetFrames() == 192 + kBurstFrames);
+    EXPECT(pass.getInputChannel(1)->getDefaultTargetFrames() == kBurstFrames * 2);
+
+    std::vector<float> guitarIn(192, 0.2f);
+    std::vector<float> micIn(kBurstFrames * 2, 0.4f);
+    std::vector<float> out(kBurstFrames * 2);
+    oboe::AudioStreamDataCallback *guitarCallback = pass.getInputCallback(0);
+    oboe::AudioStreamDataCallback *micCallback = pass.getInputCallback(1);
+
+    // One second of 1ms output bursts; the guitar delivers every 4th
+    for (int32_t i = 0; i < kOutputRate / kBurstFrames; i++) {
+        if (i % 4 == 0) guitarCallback->onAudioReady(&guitarStream, guitarIn.data(), 192);
+        micCallback->onAudioReady(&micStream, micIn.data(), kBurstFrames);
+        EXPECT(pass.onAudioReady(&outputStream, out.data(), kBurstFrames) == oboe::DataCallbackResult::Continue);
+    }
+
+    // Guitar hard left, mic hard right at half gain
+    EXPECT_NEAR(out[0], 0.2f, 1e-5f);
+    EXPECT_NEAR(out[1], 0.2f, 1e-5f);
+    for (int32_t i = 0; i < 2; i++) {
+        const InputChannel *channel = pass.getInputChannel(i);
+        EXPECT(channel->getUnderrunCount() == 0);
+        EXPECT(channel->getFramesDrained() == 0);
+        EXPECT(channel->getOverflowCount() == 0);
+    }
+    EXPECT(pass.getCurrentBufferFrames() > 0);
+
+    // A callback larger than the output buffer capacity is mixed in chunks
+    // rather than reallocating on the audio thread
+    const int32_t bigFrames = outputStream.getBufferCapacityInFrames() * 2 + 100;
+    for (int32_t i = 0; i < 4; i++) guitarCallback->onAudioReady(&guitarStream, guitarIn.data(), 192);
+    for (int32_t i = 0; i < 12; i++) micCallback->onAudioReady(&micStream, micIn.data(), kBurstFrames);
+    std::vector<float> bigOut(bigFrames * 2);
+    pass.onAudioReady(&outputStream, bigOut.data(), bigFrames);
+    EXPECT_NEAR(bigOut[0], 0.2f, 1e-5f);
+    EXPECT_NEAR(bigOut[(bigFrames - 1) * 2], 0.2f, 1e-5f);
+    EXPECT_NEAR(bigOut[(bigFrames - 1) * 2 + 1], 0.2f, 1e-5f);
+}
+
+int main() {
+    testRingWrapAround();
+    testFastSourceWithoutDrainSettings();
+    testFastSourceWithDrainRateButNoTarget();
+    testFastSourceWithDrainSettings();
+    testSlowSourceReprimes();
+    testInputBurstLargerThanOutputBurst();
+    testPanAndGainSumming();
+    testTwoInputsAtDifferentRates();
+    testMultiInputPassCallbacks();
+
+    if (sFailures > 0) {
+        fprintf(stderr, "%d failure(s)\n", sFailures);
+        return 1;
+    }
+    printf("All mixer tests passed\n");
+    return 0;
+}
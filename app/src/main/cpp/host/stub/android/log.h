@@ -0,0 +1,11 @@
+// Host stand-in for the NDK log header: logging is compiled out
+#ifndef LINEIN_HOST_STUB_ANDROID_LOG_H
+#define LINEIN_HOST_STUB_ANDROID_LOG_H
+
+#define ANDROID_LOG_INFO 4
+#define ANDROID_LOG_WARN 5
+#define ANDROID_LOG_ERROR 6
+
+inline int __android_log_print(int, const char *, const char *, ...) { return 0; }
+
+#endif // LINEIN_HOST_STUB_ANDROID_LOG_H
@@ -0,0 +1,58 @@
+// Minimal host stand-in for the parts of the Oboe API used by FullDuplexPass and
+// MultiInputPass, so the callbacks can be tested and benchmarked without a device. Stream queries are
+// virtual so the benchmark can give them a realistic cost.
+#ifndef LINEIN_HOST_STUB_OBOE_H
+#define LINEIN_HOST_STUB_OBOE_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace oboe {
+
+enum class Result { OK, ErrorNull };
+enum class DataCallbackResult { Continue, Stop };
+enum class AudioFormat { Float, I16 };
+
+namespace ChannelCount {
+    enum : int32_t { Unspecified = 0, Mono = 1, Stereo = 2 };
+}
+
+template <typename T>
+class ResultWithValue {
+public:
+    ResultWithValue(T value) : mValue(value) {}
+    explicit operator bool() const { return true; }
+    T value() const { return mValue; }
+private:
+    T mValue;
+};
+
+class AudioStream {
+public:
+    virtual ~AudioStream() = default;
+    virtual int32_t getChannelCount() const = 0;
+    virtual int32_t getSampleRate() const { return 48000; }
+    virtual AudioFormat getFormat() const { return AudioFormat::Float; }
+    virtual int32_t getFramesPerBurst() const { return 48; }
+    virtual int32_t getBufferCapacityInFrames() const { return getFramesPerBurst() * 4; }
+    int32_t getBytesPerFrame() const {
+        return getChannelCount() * (getFormat() == AudioFormat::I16 ? 2 : 4);
+    }
+    virtual ResultWithValue<int32_t> getXRunCount() { return 0; }
+    virtual ResultWithValue<int32_t> getAvailableFrames() { return 0; }
+    virtual ResultWithValue<int32_t> read(void *, int32_t numFrames, int64_t) {
+        return numFrames;
+    }
+    virtual Result requestStart() { return Result::OK; }
+    virtual Result requestStop() { return Result::OK; }
+};
+
+class AudioStreamDataCallback {
+public:
+    virtual ~AudioStreamDataCallback() = default;
+    virtual DataCallbackResult onAudioReady(AudioStream *stream, void *audioData, int32_t numFrames) = 0;
+};
+
+} // namespace oboe
+
+#endif // LINEIN_HOST_STUB_OBOE_H
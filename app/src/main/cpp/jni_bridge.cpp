@@ -108,4 +108,75 @@ Java_dev_andresfelipecaicedo_linein_PassthroughEngine_nativeGetCurrentBufferMs(J
     return -1;
 }
 
+JNIEXPORT void JNICALL
+Java_dev_andresfelipecaicedo_linein_PassthroughEngine_nativeSetInputDeviceIds(JNIEnv *env, jobject thiz,
+                                                                                 jintArray deviceIds) {
+    if (sEngine) {
+        jsize count = env->GetArrayLength(deviceIds);
+        std::vector<int32_t> ids(count);
+        env->GetIntArrayRegion(deviceIds, 0, count, ids.data());
+        sEngine->setInputDeviceIds(ids);
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_andresfelipecaicedo_linein_PassthroughEngine_nativeGetInputCount(JNIEnv *env, jobject thiz) {
+    if (sEngine) {
+        return sEngine->getInputCount();
+    }
+    return 0;
+}
+
+JNIEXPORT void JNICALL
+Java_dev_andresfelipecaicedo_linein_PassthroughEngine_nativeSetInputGain(JNIEnv *env, jobject thiz,
+                                                                            jint index, jfloat gain) {
+    if (sEngine) {
+        sEngine->setInputGain(index, gain);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_andresfelipecaicedo_linein_PassthroughEngine_nativeSetInputPan(JNIEnv *env, jobject thiz,
+                                                                           jint index, jfloat pan) {
+    if (sEngine) {
+        sEngine->setInputPan(index, pan);
+    }
+}
+
+JNIEXPORT jfloat JNICALL
+Java_dev_andresfelipecaicedo_linein_PassthroughEngine_nativeGetInputGain(JNIEnv *env, jobject thiz,
+                                                                           jint index) {
+    if (sEngine) {
+        return sEngine->getInputGain(index);
+    }
+    return 1.0f;
+}
+
+JNIEXPORT jfloat JNICALL
+Java_dev_andresfelipecaicedo_linein_PassthroughEngine_nativeGetInputPan(JNIEnv *env, jobject thiz,
+                                                                          jint index) {
+    if (sEngine) {
+        return sEngine->getInputPan(index);
+    }
+    return 0.0f;
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_andresfelipecaicedo_linein_PassthroughEngine_nativeGetInputBufferMs(JNIEnv *env, jobject thiz,
+                                                                                jint index) {
+    if (sEngine) {
+        return sEngine->getInputBufferMs(index);
+    }
+    return -1;
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_andresfelipecaicedo_linein_PassthroughEngine_nativeGetInputXRunCount(JNIEnv *env, jobject thiz,
+                                                                                 jint index) {
+    if (sEngine) {
+        return sEngine->getInputXRunCount(index);
+    }
+    return -1;
+}
+
 } // extern "C"
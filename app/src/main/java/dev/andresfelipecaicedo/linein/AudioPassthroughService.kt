@@ -68,6 +68,14 @@ class AudioPassthroughService : Service() {
             PassthroughEngine.setOutputDeviceId(it.id)
         }
 
+        // With several USB inputs (e.g. guitar and mic interfaces) mix them all
+        val usbInputDevices = findUsbAudioInputDevices()
+        if (usbInputDevices.size > 1) {
+            Log.i(TAG, "Mixing ${usbInputDevices.size} USB input devices: " +
+                    usbInputDevices.joinToString { "${it.productName} (${it.id})" })
+            PassthroughEngine.setInputDeviceIds(usbInputDevices.map { it.id }.toIntArray())
+        }
+
         PassthroughEngine.setEffectOn(true)
 
         // Start foreground with notification
@@ -113,6 +121,16 @@ class AudioPassthroughService : Service() {
         }
     }
 
+    private fun findUsbAudioInputDevices(): List<AudioDeviceInfo> {
+        val devices = audioManager?.getDevices(AudioManager.GET_DEVICES_INPUTS) ?: return emptyList()
+
+        return devices.filter { device ->
+            device.type == AudioDeviceInfo.TYPE_USB_DEVICE ||
+            device.type == AudioDeviceInfo.TYPE_USB_HEADSET ||
+            device.type == AudioDeviceInfo.TYPE_USB_ACCESSORY
+        }
+    }
+
     private fun createNotificationChannel() {
         val channel = NotificationChannel(
             CHANNEL_ID,
@@ -38,6 +38,7 @@ import androidx.compose.material3.Text
 import androidx.compose.runtime.Composable
 import androidx.compose.runtime.getValue
 import androidx.compose.runtime.mutableFloatStateOf
+import androidx.compose.runtime.mutableStateListOf
 import androidx.compose.runtime.mutableStateOf
 import androidx.compose.runtime.setValue
 import androidx.compose.ui.Alignment
@@ -53,7 +54,13 @@ data class AudioStatus(
     val outputMMAP: Boolean = false,
     val inputLatencyMs: Int = -1,
     val outputLatencyMs: Int = -1,
-    val currentBufferMs: Int = -1
+    val currentBufferMs: Int = -1,
+    val inputs: List<InputStatus> = emptyList()
+)
+
+data class InputStatus(
+    val bufferMs: Int = -1,
+    val xRunCount: Int = 0
 )
 
 class MainActivity : ComponentActivity() {
@@ -64,6 +71,8 @@ class MainActivity : ComponentActivity() {
     private var targetBufferMs by mutableStateOf(0)  // 0 = disabled
     private var drainRate by mutableFloatStateOf(0.0f)  // 0 = disabled
     private var audioStatus by mutableStateOf(AudioStatus())
+    private val inputGains = mutableStateListOf<Float>()  // multi-input mode only
+    private val inputPans = mutableStateListOf<Float>()
     private var service: AudioPassthroughService? = null
     private var isBound = false
     private val handler = Handler(Looper.getMainLooper())
@@ -107,6 +116,16 @@ class MainActivity : ComponentActivity() {
                         targetBufferMs = targetBufferMs,
                         drainRate = drainRate,
                         audioStatus = audioStatus,
+                        inputGains = inputGains,
+                        inputPans = inputPans,
+                        onInputGainChange = { index, newGain ->
+                            inputGains[index] = newGain
+                            PassthroughEngine.setInputGain(index, newGain)
+                        },
+                        onInputPanChange = { index, newPan ->
+                            inputPans[index] = newPan
+                            PassthroughEngine.setInputPan(index, newPan)
+                        },
                         onGainChange = { newGain ->
                             gain = newGain
                             if (isPassthroughActive) {
@@ -166,13 +185,30 @@ class MainActivity : ComponentActivity() {
     private fun updateAudioStatus() {
         // Delay slightly to ensure streams are fully initialized
         handler.postDelayed({
+            val inputCount = PassthroughEngine.getInputCount()
             audioStatus = AudioStatus(
                 inputMMAP = PassthroughEngine.isInputMMAP(),
                 outputMMAP = PassthroughEngine.isOutputMMAP(),
                 inputLatencyMs = PassthroughEngine.getInputLatencyMs(),
                 outputLatencyMs = PassthroughEngine.getOutputLatencyMs(),
-                currentBufferMs = PassthroughEngine.getCurrentBufferMs()
+                currentBufferMs = PassthroughEngine.getCurrentBufferMs(),
+                inputs = List(inputCount) { index ->
+                    InputStatus(
+                        bufferMs = PassthroughEngine.getInputBufferMs(index),
+                        xRunCount = PassthroughEngine.getInputXRunCount(index)
+                    )
+                }
             )
+            // Inputs can come and go on restart (e.g. an interface unplugged);
+            // the engine keeps each remaining input's settings, so read them back
+            if (inputGains.size != inputCount) {
+                inputGains.clear()
+                inputPans.clear()
+                repeat(inputCount) { index ->
+                    inputGains.add(PassthroughEngine.getInputGain(index))
+                    inputPans.add(PassthroughEngine.getInputPan(index))
+                }
+            }
             // Keep updating while active
             if (isPassthroughActive) {
                 updateAudioStatus()
@@ -190,6 +226,8 @@ class MainActivity : ComponentActivity() {
             AudioPassthroughService.stopService(this)
             isPassthroughActive = false
             audioStatus = AudioStatus()
+            inputGains.clear()
+            inputPans.clear()
         } else {
             AudioPassthroughService.startService(this)
             isPassthroughActive = true
@@ -209,6 +247,10 @@ fun MainScreen(
     targetBufferMs: Int,
     drainRate: Float,
     audioStatus: AudioStatus,
+    inputGains: List<Float>,
+    inputPans: List<Float>,
+    onInputGainChange: (Int, Float) -> Unit,
+    onInputPanChange: (Int, Float) -> Unit,
     onGainChange: (Float) -> Unit,
     onTargetBufferChange: (Int) -> Unit,
     onDrainRateChange: (Float) -> Unit,
@@ -295,6 +337,17 @@ fun MainScreen(
                 )
             }
 
+            // Per-input mix, only when several devices are mixed
+            if (isActive && inputGains.size > 1) {
+                Spacer(modifier = Modifier.height(24.dp))
+                InputMixerCard(
+                    inputGains = inputGains,
+                    inputPans = inputPans,
+                    onInputGainChange = onInputGainChange,
+                    onInputPanChange = onInputPanChange
+                )
+            }
+
             // Latency Tuning Section
             if (isActive) {
                 Spacer(modifier = Modifier.height(24.dp))
@@ -310,6 +363,91 @@ fun MainScreen(
     }
 }
 
+@Composable
+fun InputMixerCard(
+    inputGains: List<Float>,
+    inputPans: List<Float>,
+    onInputGainChange: (Int, Float) -> Unit,
+    onInputPanChange: (Int, Float) -> Unit
+) {
+    Column(
+        modifier = Modifier
+            .fillMaxWidth()
+            .padding(horizontal = 32.dp)
+            .clip(RoundedCornerShape(12.dp))
+            .background(MaterialTheme.colorScheme.surfaceVariant)
+            .padding(16.dp)
+    ) {
+        Text(
+            text = "Input Mix",
+            style = MaterialTheme.typography.titleMedium,
+            color = MaterialTheme.colorScheme.onSurfaceVariant
+        )
+
+        inputGains.forEachIndexed { index, inputGain ->
+            val pan = inputPans.getOrElse(index) { 0f }
+
+            Spacer(modifier = Modifier.height(12.dp))
+
+            Text(
+                text = "Input ${index + 1}",
+                style = MaterialTheme.typography.labelLarge,
+                color = MaterialTheme.colorScheme.onSurfaceVariant
+            )
+
+            Row(
+                modifier = Modifier.fillMaxWidth(),
+                verticalAlignment = Alignment.CenterVertically
+            ) {
+                Text(
+                    text = "Level",
+                    style = MaterialTheme.typography.bodySmall,
+                    modifier = Modifier.width(40.dp)
+                )
+                Slider(
+                    value = inputGain,
+                    onValueChange = { onInputGainChange(index, it) },
+                    valueRange = 0f..2f,
+                    modifier = Modifier.weight(1f)
+                )
+                Spacer(modifier = Modifier.width(8.dp))
+                Text(
+                    text = String.format("%.1fx", inputGain),
+                    style = MaterialTheme.typography.bodyMedium,
+                    modifier = Modifier.width(48.dp)
+                )
+            }
+
+            Row(
+                modifier = Modifier.fillMaxWidth(),
+                verticalAlignment = Alignment.CenterVertically
+            ) {
+                Text(
+                    text = "Pan",
+                    style = MaterialTheme.typography.bodySmall,
+                    modifier = Modifier.width(40.dp)
+                )
+                Slider(
+                    value = pan,
+                    onValueChange = { onInputPanChange(index, it) },
+                    valueRange = -1f..1f,
+                    modifier = Modifier.weight(1f)
+                )
+                Spacer(modifier = Modifier.width(8.dp))
+                Text(
+                    text = when {
+                        pan < -0.05f -> "L${(-pan * 100).toInt()}"
+                        pan > 0.05f -> "R${(pan * 100).toInt()}"
+                        else -> "C"
+                    },
+                    style = MaterialTheme.typography.bodyMedium,
+                    modifier = Modifier.width(48.dp)
+                )
+            }
+        }
+    }
+}
+
 @Composable
 fun LatencyTuningCard(
     targetBufferMs: Int,
@@ -530,6 +668,30 @@ fun AudioStatusCard(status: AudioStatus) {
             }
         }
 
+        // Per-input buffer level and XRuns in multi-input mode
+        if (status.inputs.size > 1) {
+            Spacer(modifier = Modifier.height(12.dp))
+            status.inputs.forEachIndexed { index, input ->
+                Row(
+                    modifier = Modifier.fillMaxWidth(),
+                    horizontalArrangement = Arrangement.SpaceBetween
+                ) {
+                    Text(
+                        text = "Input ${index + 1}:",
+                        style = MaterialTheme.typography.bodyMedium,
+                        color = MaterialTheme.colorScheme.onSurfaceVariant
+                    )
+                    Text(
+                        text = (if (input.bufferMs >= 0) "${input.bufferMs}ms" else "---") +
+                               " · ${input.xRunCount} XRuns",
+                        style = MaterialTheme.typography.bodyMedium,
+                        color = if (input.xRunCount > 0) MaterialTheme.colorScheme.error
+                               else MaterialTheme.colorScheme.primary
+                    )
+                }
+            }
+        }
+
         if (!status.inputMMAP || !status.outputMMAP) {
             Spacer(modifier = Modifier.height(12.dp))
             Text(
@@ -17,6 +17,14 @@ object PassthroughEngine {
     external fun nativeSetTargetBufferMs(ms: Int)
     external fun nativeSetDrainRate(rate: Float)
     external fun nativeGetCurrentBufferMs(): Int
+    external fun nativeSetInputDeviceIds(deviceIds: IntArray)
+    external fun nativeGetInputCount(): Int
+    external fun nativeSetInputGain(index: Int, gain: Float)
+    external fun nativeSetInputPan(index: Int, pan: Float)
+    external fun nativeGetInputGain(index: Int): Float
+    external fun nativeGetInputPan(index: Int): Float
+    external fun nativeGetInputBufferMs(index: Int): Int
+    external fun nativeGetInputXRunCount(index: Int): Int
 
     fun create(): Boolean = nativeCreate()
 
@@ -41,4 +49,21 @@ object PassthroughEngine {
     fun setDrainRate(rate: Float) = nativeSetDrainRate(rate)
 
     fun getCurrentBufferMs(): Int = nativeGetCurrentBufferMs()
+
+    // Two or more IDs enable multi-input mode (all inputs mixed into the output)
+    fun setInputDeviceIds(deviceIds: IntArray) = nativeSetInputDeviceIds(deviceIds)
+
+    fun getInputCount(): Int = nativeGetInputCount()
+
+    fun setInputGain(index: Int, gain: Float) = nativeSetInputGain(index, gain)
+
+    fun setInputPan(index: Int, pan: Float) = nativeSetInputPan(index, pan)
+
+    fun getInputGain(index: Int): Float = nativeGetInputGain(index)
+
+    fun getInputPan(index: Int): Float = nativeGetInputPan(index)
+
+    fun getInputBufferMs(index: Int): Int = nativeGetInputBufferMs(index)
+
+    fun getInputXRunCount(index: Int): Int = nativeGetInputXRunCount(index)
 }